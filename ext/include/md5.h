@@ -18,9 +18,9 @@ typedef struct {
 } MD5Context;
 
 void md5Init(MD5Context* ctx);
-void md5Update(MD5Context* ctx, uint8_t* input, size_t input_len);
+void md5Update(MD5Context* ctx, const uint8_t* input, size_t input_len);
 void md5Finalize(MD5Context* ctx);
-void md5Step(uint32_t* buffer, uint32_t* input);
+void md5Step(uint32_t* buffer, const uint32_t* input);
 
 void md5String(char* input, size_t inputLen, uint8_t* result);
 void md5File(FILE* file, uint8_t* result);
@@ -0,0 +1,29 @@
+#ifndef XXH64_H
+#define XXH64_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t size;      // Size of input in bytes
+    uint64_t state[4];  // Lane accumulators
+    uint64_t seed;      // Used directly for inputs shorter than a stripe
+    uint8_t input[32];  // Partial stripe to be used in the next update
+    uint8_t digest[8];  // Result of algorithm, canonical (big-endian) order
+} XXH64Context;
+
+void xxh64Init(XXH64Context* ctx, uint64_t seed);
+void xxh64Update(XXH64Context* ctx, const uint8_t* input, size_t input_len);
+void xxh64Finalize(XXH64Context* ctx);
+
+void xxh64(const uint8_t* input, size_t input_len, uint64_t seed, uint8_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Streaming XXH64, written from the xxHash specification (XXH64 section).
+ * Produces the same digests as the reference implementation.
+ */
+
+#include <string.h>
+#include <xxh64.h>
+
+/*
+ * Primes defined by the XXH64 algorithm
+ */
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+/*
+ * Little-endian targets can read lanes with a plain (possibly unaligned) load
+ */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+#else
+static inline uint64_t read64(const uint8_t* p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+#endif
+
+static inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = ROTATE_LEFT(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round64(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+/*
+ * Consume whole 32 byte stripes, returns the number of bytes used
+ */
+static size_t xxh64Stripes(uint64_t* state, const uint8_t* input, size_t input_len) {
+    const uint8_t* p   = input;
+    const uint8_t* end = input + (input_len & ~(size_t)31);
+
+    uint64_t v1 = state[0];
+    uint64_t v2 = state[1];
+    uint64_t v3 = state[2];
+    uint64_t v4 = state[3];
+
+    for(; p < end; p += 32) {
+        v1 = round64(v1, read64(p));
+        v2 = round64(v2, read64(p + 8));
+        v3 = round64(v3, read64(p + 16));
+        v4 = round64(v4, read64(p + 24));
+    }
+
+    state[0] = v1;
+    state[1] = v2;
+    state[2] = v3;
+    state[3] = v4;
+
+    return (size_t)(p - input);
+}
+
+void xxh64Init(XXH64Context* ctx, uint64_t seed) {
+    ctx->size     = 0;
+    ctx->seed     = seed;
+    ctx->state[0] = seed + PRIME64_1 + PRIME64_2;
+    ctx->state[1] = seed + PRIME64_2;
+    ctx->state[2] = seed;
+    ctx->state[3] = seed - PRIME64_1;
+}
+
+void xxh64Update(XXH64Context* ctx, const uint8_t* input, size_t input_len) {
+    unsigned int offset = ctx->size % 32;
+    ctx->size += (uint64_t)input_len;
+
+    if(offset != 0) {
+        size_t fill = 32 - offset;
+        if(input_len < fill) {
+            memcpy(ctx->input + offset, input, input_len);
+            return;
+        }
+
+        memcpy(ctx->input + offset, input, fill);
+        xxh64Stripes(ctx->state, ctx->input, 32);
+
+        input += fill;
+        input_len -= fill;
+    }
+
+    size_t used = xxh64Stripes(ctx->state, input, input_len);
+    if(input_len > used) {
+        memcpy(ctx->input, input + used, input_len - used);
+    }
+}
+
+void xxh64Finalize(XXH64Context* ctx) {
+    uint64_t h;
+    if(ctx->size >= 32) {
+        h = ROTATE_LEFT(ctx->state[0], 1) + ROTATE_LEFT(ctx->state[1], 7) + ROTATE_LEFT(ctx->state[2], 12) + ROTATE_LEFT(ctx->state[3], 18);
+        h = mergeRound(h, ctx->state[0]);
+        h = mergeRound(h, ctx->state[1]);
+        h = mergeRound(h, ctx->state[2]);
+        h = mergeRound(h, ctx->state[3]);
+    }
+    else {
+        h = ctx->seed + PRIME64_5;
+    }
+
+    h += ctx->size;
+
+    // Remaining bytes of the last partial stripe
+    const uint8_t* p   = ctx->input;
+    const uint8_t* end = ctx->input + (ctx->size % 32);
+
+    for(; p + 8 <= end; p += 8) {
+        h ^= round64(0, read64(p));
+        h = ROTATE_LEFT(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+
+    if(p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = ROTATE_LEFT(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+
+    for(; p < end; p++) {
+        h ^= (*p) * PRIME64_5;
+        h = ROTATE_LEFT(h, 11) * PRIME64_1;
+    }
+
+    // Avalanche
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+
+    for(unsigned int i = 0; i < 8; ++i) {
+        ctx->digest[i] = (uint8_t)(h >> (56 - i * 8));
+    }
+}
+
+void xxh64(const uint8_t* input, size_t input_len, uint64_t seed, uint8_t* result) {
+    XXH64Context ctx;
+    xxh64Init(&ctx, seed);
+
+    xxh64Update(&ctx, input, input_len);
+    xxh64Finalize(&ctx);
+
+    memcpy(result, ctx.digest, 8);
+}
@@ -3,6 +3,7 @@
 
 #include <Client.hpp>
 #include <Config.hpp>
+#include <Debug/Benchmark.hpp>
 #include <TitleLoader.hpp>
 #include <UI/MainScreen.hpp>
 #include <clay_renderer_C2D.hpp>
@@ -68,6 +69,9 @@ private:
 
     std::vector<u16> m_dummyTopFramebuffer;
     std::vector<u16> m_dummyBottomFramebuffer;
+
+    // started with L + select, results go to the console
+    std::unique_ptr<Benchmark> m_benchmark;
 #endif
 };
 
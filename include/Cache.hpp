@@ -1,23 +1,97 @@
 #ifndef __CACHE_HPP__
 #define __CACHE_HPP__
 
+#include <3ds.h>
+
 #include <FS/File.hpp>
-#include <Title.hpp>
+#include <Util/Mutex.hpp>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
+// single file record store, cache holds the packed record data and cache.map a fixed size entry per record
+// records are keyed by title id, anything else stored here needs a key that can't be a title id
 class Cache {
 public:
-    Cache();
+    static std::shared_ptr<Cache> instance();
+    static void close();
+
     ~Cache();
 
     bool valid() const;
-    void updateTitle(std::shared_ptr<Title> title);
+
+    bool contains(u64 key);
+    // false if the record doesn't exist or is corrupt
+    bool read(u64 key, std::vector<u8>& data);
+    bool write(u64 key, const std::vector<u8>& data);
+    bool remove(u64 key);
+
+    // packs all records to the start of the cache file, runs automatically once enough space is free
+    bool compact();
+
+private:
+    Cache();
+
+    static constexpr char MAP_MAGIC[4] = { 'S', 'S', 'C', 'M' };
+    static constexpr u16 MAP_VERSION   = 1;
+
+    // records get some headroom so small growth can be written in place
+    static constexpr u32 RECORD_ALIGN = 0x200;
+    // compacts when free space is over this and over half the used space
+    static constexpr u64 COMPACT_MIN_FREE = 0x80000;
+
+    struct MapHeader {
+        char magic[4];
+        u16 version;
+        u16 entrySize;
+    };
+
+    // a key of zero marks a free slot
+    struct MapEntry {
+        u64 key;
+        u32 offset;
+        u32 length;
+        u32 capacity;
+        // crc32 of the record data
+        u32 checksum;
+    };
+
+    struct Record {
+        u32 slot;
+        u32 offset;
+        u32 length;
+        u32 capacity;
+        u32 checksum;
+    };
+
+    static u32 recordCapacity(u32 length);
+
+    bool reset();
+    bool loadMap();
+
+    bool writeEntry(u64 key, const Record& record);
+    bool clearSlot(u32 slot);
+    u32 takeSlot();
+
+    // offset of the first gap that fits capacity, otherwise the end of the data
+    u64 allocate(u32 capacity);
+    u64 dataEnd() const;
+    u64 freeSpace() const;
+
+    // both expect the mutex to be held
+    void compactIfNeeded();
+    bool compactLocked();
 
 private:
     bool m_valid;
+    Mutex m_mutex;
+
     std::shared_ptr<File> m_cacheFile;
     std::shared_ptr<File> m_mapFile;
+
+    std::unordered_map<u64, Record> m_records;
+    std::vector<u32> m_freeSlots;
+    u32 m_slotCount;
 };
 
-#endif
\ No newline at end of file
+#endif
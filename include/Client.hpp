@@ -4,8 +4,10 @@
 #include <3ds.h>
 #include <curl/curl.h>
 
+#include <FS/BufferedFile.hpp>
 #include <Title.hpp>
 #include <Util/CondVar.hpp>
+#include <Util/Hasher.hpp>
 #include <Util/Mutex.hpp>
 #include <Util/Worker.hpp>
 #include <atomic>
@@ -59,6 +61,9 @@ public:
     std::unordered_map<u64, TitleInfo> cachedTitleInfo();
     bool cachedTitleInfoLoaded() const;
 
+    // negotiated with the server each time it comes online, md5 for servers without the capabilities endpoint
+    HashAlgorithm hashAlgorithm() const;
+
     void queueAction(QueuedRequest request);
 
     void startQueueWorker();
@@ -85,6 +90,8 @@ public:
     rocket::thread_safe_signal<void(const u64&, const TitleInfo&)> titleInfoChangedSignal;
     rocket::thread_safe_signal<void(const std::string&)> requestStatusChangedSignal;
     rocket::thread_safe_signal<void(const std::string&)> requestFailedSignal;
+    // sent after every successful negotiation, even if the algorithm didn't change
+    rocket::thread_safe_signal<void(const HashAlgorithm&)> hashAlgorithmChangedSignal;
 
 public:
     static Result noFilesUploadError();
@@ -113,6 +120,9 @@ private:
 
         std::optional<u64> size;
         std::optional<std::string> hash;
+
+        // the one the download was started with
+        HashAlgorithm hashAlgorithm;
     };
 
     // ticket is the identifier for the upload (uuidv4), will be overwritten with the output ticket
@@ -120,13 +130,16 @@ private:
     Result beginDownload(std::shared_ptr<Title> title, Container container, std::string& ticket, std::vector<DownloadAction>& fileActions);
 
     Result uploadFile(const std::string& ticket, std::shared_ptr<File> file, const std::string& path);
-    Result downloadFile(const std::string& ticket, std::shared_ptr<File> file, const std::string& path);
+    // writes through writer, which is reused between files, anything the server doesn't send up to size is zeroed
+    Result downloadFile(const std::string& ticket, BufferedFileWriter& writer, std::shared_ptr<File> file, const std::string& path, u64 size);
 
     Result endUpload(const std::string& ticket);
     Result endDownload(const std::string& ticket);
 
     Result cancelUpload(const std::string& ticket);
 
+    // picks the hash algorithm, fails only if the server couldn't be reached
+    Result loadCapabilities();
     Result loadTitleInfoCache();
     void clearTitleInfoCache();
 
@@ -163,6 +176,7 @@ private:
     std::string m_requestStatus;
 
     std::atomic<bool> m_titleInfoCached;
+    std::atomic<HashAlgorithm> m_hashAlgorithm;
 
     bool m_processRequests;
     bool m_processingQueueRequest;
@@ -5,6 +5,7 @@
 
 #include <FS/Archive.hpp>
 #include <FS/File.hpp>
+#include <Util/Hasher.hpp>
 #include <rocket.hpp>
 #include <string>
 #include <unordered_map>
@@ -53,6 +54,10 @@ public:
     std::shared_ptr<Option<std::string>> serverURL();
     std::shared_ptr<Option<u16>> serverPort();
     std::shared_ptr<Option<Layout>> layout();
+    // last algorithm negotiated with the server, kept so hashing at boot doesn't wait for the server
+    std::shared_ptr<Option<HashAlgorithm>> hashAlgorithm();
+    // title selected when the app was last closed, 0 if none, it's loaded and shown first
+    std::shared_ptr<Option<u64>> lastTitle();
 
     void load();
     void save();
@@ -63,6 +68,8 @@ private:
     std::shared_ptr<Option<std::string>> m_serverURL;
     std::shared_ptr<Option<u16>> m_serverPort;
     std::shared_ptr<Option<Layout>> m_layout;
+    std::shared_ptr<Option<HashAlgorithm>> m_hashAlgorithm;
+    std::shared_ptr<Option<u64>> m_lastTitle;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+#include <3ds.h>
+
+#include <FS/AlignedBuffer.hpp>
+#include <FS/Archive.hpp>
+#include <Title.hpp>
+#include <Util/Hasher.hpp>
+#include <Util/Worker.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// generates synthetic save trees on the sd card and times the title scan, hash, file read and cache paths on them
+// trees are only generated once, delete /3ds/SaveSync/benchmark to regenerate
+class Benchmark {
+public:
+    struct TreeProfile {
+        const char* name;
+
+        u32 fileCount;
+        u32 fileSize;
+
+        // files are spread over width branches, each a chain of depth nested directories
+        u32 width;
+        u32 depth;
+    };
+
+    struct TreeResult {
+        size_t files;
+        u64 bytes;
+
+        // all in ticks
+        u64 walk;
+        // fresh hash with each algorithm, in HashAlgorithm order
+        u64 hash[2];
+        // md5 again with the block digests from the first pass
+        u64 rehash;
+        // every file read with a new vector per call, then into one reused buffer
+        u64 vectorRead;
+        u64 spanRead;
+        // one per vector read, the span reads only allocate their buffer once
+        u64 vectorAllocations;
+        u64 cacheWrite;
+        u64 cacheRead;
+    };
+
+    // many tiny files, a few huge files, deep nesting and pokemon style 1MB saves
+    static const std::vector<TreeProfile>& defaultProfiles();
+
+    Benchmark(std::vector<TreeProfile> profiles = defaultProfiles());
+    ~Benchmark();
+
+    // runs in the background, each tree is logged as it finishes
+    void start();
+    bool running() const;
+
+private:
+    void workerMain();
+
+    std::u16string treeRoot(const TreeProfile& profile) const;
+
+    bool generate(const TreeProfile& profile);
+    bool run(const TreeProfile& profile, TreeResult& result);
+    // U64_MAX if a file couldn't be read, buffer null to read into a new vector each call
+    u64 readFiles(const std::vector<FileInfo>& files, AlignedBuffer* buffer, u64& reads);
+
+    void logResult(const TreeProfile& profile, const TreeResult& result) const;
+
+private:
+    std::vector<TreeProfile> m_profiles;
+    std::shared_ptr<Archive> m_sdmc;
+
+    std::unique_ptr<Worker> m_worker;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef __LOGGER_HPP__
 #define __LOGGER_HPP__
 
+#include <FS/BufferedFile.hpp>
 #include <FS/File.hpp>
 #include <Util/Defines.hpp>
 #include <Util/Mutex.hpp>
@@ -99,6 +100,8 @@ private:
 
     static Mutex s_fileMutex;
     static std::shared_ptr<File> s_file;
+    // appends at the end of the log without asking the file for its size every message
+    static std::unique_ptr<BufferedFileWriter> s_writer;
 };
 
 #endif
\ No newline at end of file
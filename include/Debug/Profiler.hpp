@@ -37,6 +37,12 @@ public:
         u64 average;
     };
 
+    struct ThroughputEntry {
+        std::string name;
+        u64 bytes;
+        u64 ticks;
+    };
+
     // doesn't require stopping, ends when block ends
     [[nodiscard]] static ProfilerScope start(std::string scopeName);
 
@@ -45,6 +51,10 @@ public:
     static u64 getScopeAverage(std::string scopeName);
     static std::vector<AveragedEntry> getAverages();
 
+    // accumulates bytes processed in ticks under name
+    static void addThroughput(std::string name, u64 bytes, u64 ticks);
+    static std::vector<ThroughputEntry> getThroughputs();
+
 private:
     static void stop(u64 id);
 
@@ -61,6 +71,7 @@ private:
     // key is the thread priority, number is start time
     static std::map<u64, RunningEntry> s_runningEntries;
     static std::map<std::string, ProfilerEntry> s_entries;
+    static std::map<std::string, ThroughputEntry> s_throughputs;
 
     static Mutex s_entriesMutex;
     static Mutex s_runningEntriesMutex;
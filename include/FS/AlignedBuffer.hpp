@@ -0,0 +1,38 @@
+#ifndef __FS_ALIGNED_BUFFER_HPP__
+#define __FS_ALIGNED_BUFFER_HPP__
+
+#include <3ds.h>
+
+#include <span>
+
+// heap buffer for fs transfers, owned by the caller and reused across reads instead of a vector per call
+class AlignedBuffer {
+public:
+    // fs transfers are faster from page aligned buffers
+    static constexpr size_t DEFAULT_ALIGNMENT = 0x1000;
+
+    AlignedBuffer(size_t size = 0, size_t alignment = DEFAULT_ALIGNMENT);
+    ~AlignedBuffer();
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept;
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+
+    // false if the allocation failed
+    bool valid() const;
+
+    u8* data();
+    const u8* data() const;
+    size_t size() const;
+
+    std::span<u8> span();
+    std::span<const u8> span() const;
+
+private:
+    u8* m_data;
+    size_t m_size;
+};
+
+#endif
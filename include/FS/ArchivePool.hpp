@@ -0,0 +1,59 @@
+#ifndef __FS_ARCHIVE_POOL_HPP__
+#define __FS_ARCHIVE_POOL_HPP__
+
+#include <3ds.h>
+
+#include <FS/Archive.hpp>
+#include <Util/Mutex.hpp>
+#include <functional>
+#include <list>
+#include <memory>
+
+// keeps title archives open between uses, every open is an fs ipc call and a title's load, hash and sync each open the same ones
+// archives are shared while in use, once only the pool holds one it's idle and the least recently used idle ones are closed past the limit
+class ArchivePool {
+public:
+    // fs only allows so many archives open at once, the app opens others besides these
+    static constexpr size_t DEFAULT_MAX_IDLE = 4;
+
+    using Opener = std::function<std::shared_ptr<Archive>()>;
+
+    static std::shared_ptr<ArchivePool> instance();
+    static void close();
+
+    ~ArchivePool();
+
+    // the pooled archive for the title's container if there is one, otherwise opens it with open
+    // only valid archives are pooled, so a failed open is tried again next time
+    std::shared_ptr<Archive> acquire(u64 id, FS_MediaType mediaType, u8 container, const Opener& open);
+
+    // closes the title's pooled archives once they're no longer in use, the next acquire opens them again
+    void invalidate(u64 id, FS_MediaType mediaType);
+    // every title on the media type, for when the game card is removed
+    void invalidate(FS_MediaType mediaType);
+
+    size_t maxIdle() const;
+    void setMaxIdle(size_t maxIdle);
+
+private:
+    ArchivePool();
+
+    // expects the mutex to be held
+    void trim();
+
+    struct Entry {
+        u64 id;
+        FS_MediaType mediaType;
+        u8 container;
+
+        std::shared_ptr<Archive> archive;
+    };
+
+    Mutex m_mutex;
+    // most recently acquired first, few enough titles are in use at once that a list is fine
+    std::list<Entry> m_entries;
+
+    size_t m_maxIdle;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef __FS_BUFFERED_FILE_HPP__
+#define __FS_BUFFERED_FILE_HPP__
+
+#include <3ds.h>
+
+#include <FS/AlignedBuffer.hpp>
+#include <FS/File.hpp>
+#include <memory>
+#include <span>
+
+// sequential reads through a large buffer, the file is read a whole buffer at a time however small the caller's reads are
+// not thread safe, meant for a single stream like a curl read callback
+class BufferedFileReader {
+public:
+    static constexpr u32 DEFAULT_BUFFER_SIZE = 0x20000;
+
+    BufferedFileReader(std::shared_ptr<File> file, u64 offset = 0, u32 bufferSize = DEFAULT_BUFFER_SIZE);
+
+    bool valid() const;
+
+    // less than data.size() only at the end of the file, U64_MAX if failed
+    // reads at least a buffer long skip the buffer and go straight into data
+    u64 read(std::span<u8> data);
+
+    // offset of the next byte read
+    u64 tell() const;
+    // keeps the buffer if offset is inside it
+    void seek(u64 offset);
+
+private:
+    std::shared_ptr<File> m_file;
+    AlignedBuffer m_buffer;
+
+    // file offset of the start of the buffer
+    u64 m_bufferOffset;
+    u32 m_bufferFilled;
+    u32 m_position;
+};
+
+// coalesces small sequential writes into a large buffer, written out once full or on flush
+// not thread safe, meant for a single stream like a curl write callback
+class BufferedFileWriter {
+public:
+    static constexpr u32 DEFAULT_BUFFER_SIZE = 0x20000;
+
+    // flags are passed to every write to the file
+    BufferedFileWriter(std::shared_ptr<File> file, u64 offset = 0, u32 bufferSize = DEFAULT_BUFFER_SIZE, u32 flags = 0);
+    // flushes, call flush first to know if it failed
+    ~BufferedFileWriter();
+
+    // flushes to the current file first, false if that failed, the buffer is reused so many files can share one writer
+    bool open(std::shared_ptr<File> file, u64 offset = 0);
+    // drops the buffered bytes and the file without writing anything, for when what was written is being abandoned
+    void discard();
+
+    bool valid() const;
+
+    // false if a write failed, nothing is written after that
+    // writes at least a buffer long skip the buffer once it has been written out
+    bool write(std::span<const u8> data);
+    // writes count zero bytes without allocating them
+    bool writeZeros(u64 count);
+    // writes out the buffer, false if failed
+    bool flush();
+
+    // offset of the next byte written
+    u64 tell() const;
+
+private:
+    bool writeOut(std::span<const u8> data);
+
+private:
+    std::shared_ptr<File> m_file;
+    AlignedBuffer m_buffer;
+    u32 m_flags;
+
+    // file offset of the start of the buffer
+    u64 m_bufferOffset;
+    u32 m_bufferFilled;
+
+    bool m_failed;
+};
+
+#endif
@@ -3,8 +3,10 @@
 
 #include <3ds.h>
 
+#include <iterator>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Archive;
@@ -66,4 +68,91 @@ private:
     std::vector<std::shared_ptr<DirectoryEntry>> m_entries;
 };
 
+// an entry straight from a DirectoryReader's batch, only valid until the reader reads the next batch
+class DirectoryEntryView {
+public:
+    DirectoryEntryView(const FS_DirectoryEntry* entry, const std::u16string* prefix) noexcept;
+
+    // same as the reader's path
+    const std::u16string& prefix() const;
+    std::u16string_view name() const;
+    // allocates, unlike the rest
+    std::u16string path() const;
+
+    bool isDirectory() const;
+    bool isFile() const;
+
+    bool isHidden() const;
+    bool isReadOnly() const;
+
+    // from the directory listing, no need to open the file
+    u64 fileSize() const;
+
+private:
+    const FS_DirectoryEntry* m_entry;
+    const std::u16string* m_prefix;
+};
+
+// walks a directory a batch of entries at a time instead of building every entry up front like Directory
+// the batch buffer is reused for every directory opened with the same reader
+class DirectoryReader {
+public:
+    static constexpr u32 DEFAULT_BATCH_SIZE = 32;
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = DirectoryEntryView;
+        using difference_type   = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(DirectoryReader* reader);
+
+        DirectoryEntryView operator*() const;
+        iterator& operator++();
+
+        bool operator==(const iterator& other) const;
+
+    private:
+        // null at the end
+        DirectoryReader* m_reader = nullptr;
+    };
+
+    DirectoryReader(u32 batchSize = DEFAULT_BATCH_SIZE);
+    DirectoryReader(std::shared_ptr<Archive> archive, std::u16string path, u32 batchSize = DEFAULT_BATCH_SIZE);
+    ~DirectoryReader();
+
+    DirectoryReader(const DirectoryReader&) = delete;
+
+    // closes the current directory first, false if failed
+    bool open(std::shared_ptr<Archive> archive, std::u16string path);
+    void close();
+
+    bool valid() const;
+    // always ends with a '/'
+    const std::u16string& path() const;
+
+    Result lastResult() const;
+
+    // a single pass, the iteration ends early if a read failed, check lastResult after
+    iterator begin();
+    iterator end();
+
+private:
+    bool readBatch();
+
+    bool m_valid;
+    Handle m_handle;
+    std::u16string m_path;
+
+    Result m_lastResult;
+    std::shared_ptr<Archive> m_archive;
+
+    std::vector<FS_DirectoryEntry> m_batch;
+    u32 m_batchFilled;
+    u32 m_batchPosition;
+    // the last read came back short, there's nothing left to read
+    bool m_lastBatch;
+};
+
 #endif
\ No newline at end of file
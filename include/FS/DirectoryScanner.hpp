@@ -0,0 +1,55 @@
+#ifndef __FS_DIRECTORY_SCANNER_HPP__
+#define __FS_DIRECTORY_SCANNER_HPP__
+
+#include <3ds.h>
+
+#include <FS/Archive.hpp>
+#include <FS/Directory.hpp>
+#include <Util/CondVar.hpp>
+#include <Util/Mutex.hpp>
+#include <Util/WorkerPool.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+// walks a directory tree breadth first, the frontier is shared with helpers so several directories are read at once
+// files come straight from the directory listings with their size, none of them are opened
+// most of a walk is spent waiting on fs, so the helpers run on the caller's core at the caller's priority by default
+class DirectoryScanner {
+public:
+    static constexpr size_t DEFAULT_HELPERS = 2;
+
+    // called for every file, one call at a time so it doesn't have to be thread safe
+    using FileFunc = std::function<void(const DirectoryEntryView& entry)>;
+
+    DirectoryScanner(const DirectoryScanner&) = delete;
+
+    // SYSCORE only allows one of our threads, a scanner made there has no helpers
+    DirectoryScanner(size_t helpers = DEFAULT_HELPERS, Worker::Processor processor = Worker::currentProcessor());
+    ~DirectoryScanner();
+
+    // the helpers are only started once there's more than one directory waiting, a flat save is read by the caller alone
+    // false if a directory couldn't be read, the files in the rest are still passed to func
+    bool scan(std::shared_ptr<Archive> archive, std::u16string root, FileFunc func);
+
+private:
+    // takes directories off the frontier until it's empty and none are being read
+    void drain(bool startHelpers);
+
+    std::unique_ptr<WorkerPool> m_helpers;
+
+    // its mutex guards the frontier, reading and failed
+    ConditionVariable m_frontierChanged;
+    std::deque<std::u16string> m_frontier;
+    // directories taken off the frontier that are still being read, they can add more
+    size_t m_reading;
+    bool m_failed;
+
+    std::shared_ptr<Archive> m_archive;
+
+    Mutex m_funcMutex;
+    FileFunc m_func;
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <FS/FSUtil.hpp>
 #include <memory>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -31,17 +32,22 @@ public:
     // U64_MAX if failed
     u64 size();
     // UINT32_MAX if failed
+    u32 write(std::span<const u8> data, u64 offset, u32 flags = 0);
     u32 write(const std::vector<u8>& data, u64 offset, u32 flags = 0);
     u32 write(const void* data, u64 dataSize, u64 offset, u32 flags = 0);
 
+    // reads straight into the caller's buffer, up to data.size() bytes
+    // prefer this with a reused buffer (see AlignedBuffer) over the vector and string reads, those allocate every call
+    // U64_MAX if failed
+    u64 read(std::span<u8> data, u64 offset);
+    // U64_MAX if failed
+    u64 read(void* data, u32 max, u64 offset);
+
     std::vector<u8> read(u32 max, u64 offset);
     bool read(std::vector<u8>& data, u32 max, u64 offset);
 
     std::string readStr(u32 max, u64 offset);
-
-    // U64_MAX if failed
-    u64 read(void* data, u32 max, u64 offset);
-
+    // without the newline
     std::string readLine(u64 offset);
 
 private:
@@ -0,0 +1,60 @@
+#ifndef __FS_READ_PIPELINE_HPP__
+#define __FS_READ_PIPELINE_HPP__
+
+#include <3ds.h>
+
+#include <FS/AlignedBuffer.hpp>
+#include <FS/File.hpp>
+#include <Util/Worker.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// reads files through two alternating buffers, a reader worker fills one while the caller processes the other
+// meant to be kept around and reused for many files by a single thread
+// the reader runs on the caller's core by default, SYSCORE only allows one of our threads so a pipeline made there reads directly
+class ReadPipeline {
+public:
+    static constexpr u32 DEFAULT_BUFFER_SIZE = 0x20000;
+
+    // return false to stop reading early
+    using ChunkFunc = std::function<bool(const u8* data, u32 size)>;
+
+    ReadPipeline(const ReadPipeline&) = delete;
+
+    ReadPipeline(u32 bufferSize = DEFAULT_BUFFER_SIZE, Worker::Processor processor = Worker::currentProcessor());
+    ~ReadPipeline();
+
+    bool valid() const;
+    u32 bufferSize() const;
+
+    // calls func with every chunk of the file in order, all chunks are bufferSize bytes except the last
+    // files that fit in a single buffer are read directly without the worker
+    // U64_MAX if a read failed, otherwise the number of bytes passed to func
+    u64 read(std::shared_ptr<File> file, ChunkFunc func);
+
+private:
+    void readerMain(Worker* worker);
+    u64 readDirect(std::shared_ptr<File> file, ChunkFunc& func);
+
+    struct Slot {
+        AlignedBuffer buffer;
+        // U64_MAX if failed
+        u64 size;
+
+        // released by the caller when the slot can be filled, by the reader when it has been
+        LightSemaphore empty;
+        LightSemaphore full;
+    };
+
+    u32 m_bufferSize;
+    Slot m_slots[2];
+
+    LightSemaphore m_job;
+    std::shared_ptr<File> m_file;
+    std::atomic<bool> m_cancel;
+
+    std::unique_ptr<Worker> m_reader;
+};
+
+#endif
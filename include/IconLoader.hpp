@@ -0,0 +1,78 @@
+#ifndef __ICON_LOADER_HPP__
+#define __ICON_LOADER_HPP__
+
+#include <3ds.h>
+
+#include <Title.hpp>
+#include <Util/IconAtlas.hpp>
+#include <Util/Mutex.hpp>
+#include <Util/Worker.hpp>
+#include <deque>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// loads title icons in the background as they're requested, the least recently requested are unloaded past the budget
+// everything but the loading runs on the render thread, so an icon never changes while a frame is being drawn
+// loaded icons are packed into an IconAtlas, an unloaded icon's slot is reused by the next one
+class IconLoader {
+public:
+    // linear memory per icon, its share of an atlas page
+    static constexpr size_t ICON_SIZE = IconAtlas::PAGE_SIZE / IconAtlas::SLOTS_PER_PAGE;
+    // a few screens worth of the grid, fits in one page
+    static constexpr size_t DEFAULT_BUDGET = IconAtlas::PAGE_SIZE;
+
+    IconLoader(size_t budget = DEFAULT_BUDGET);
+    ~IconLoader();
+
+    // titles on screen first then the ones to prefetch, replaces the last request
+    // also sets icons loaded since the last call and unloads any over the budget
+    void request(const std::vector<std::shared_ptr<Title>>& titles);
+
+    size_t budget() const;
+    void setBudget(size_t budget);
+
+private:
+    void workerMain();
+
+    // keyed by address, an entry only counts while its title is still alive
+    using TitleSet = std::unordered_map<const Title*, std::weak_ptr<Title>>;
+    static bool contains(const TitleSet& set, const std::shared_ptr<Title>& title);
+
+    // expects the mutex to be held
+    bool queued(const Title* title) const;
+
+    void setLoaded(const std::shared_ptr<Title>& title, std::shared_ptr<IconAtlas::Slot> slot);
+    // unloads the least recently requested until at most maxLoaded are left, returns how many were unloaded
+    size_t evict(size_t maxLoaded);
+    // removed titles and game cards no longer inserted, returns how many were unloaded
+    size_t evictInvalid();
+
+private:
+    size_t m_budget;
+    IconAtlas m_atlas;
+
+    // titles with an icon set, most recently requested first
+    std::list<std::shared_ptr<Title>> m_loaded;
+    std::unordered_map<const Title*, std::list<std::shared_ptr<Title>>::iterator> m_loadedIndex;
+
+    std::vector<const Title*> m_lastRequest;
+    // icons that couldn't be read, not retried as they would fail the same way again
+    TitleSet m_failed;
+    // no atlas slot was free and a new page couldn't be allocated, retried once an icon is unloaded
+    TitleSet m_noSlot;
+
+    Mutex m_mutex;
+    std::deque<std::shared_ptr<Title>> m_pending;
+    // the title the worker is loading, null if none
+    const Title* m_loading;
+    // set while the worker is taking from m_pending, it's only started again once this is cleared
+    bool m_working;
+    // tiled icon data, empty if it failed to load
+    std::vector<std::pair<std::shared_ptr<Title>, std::vector<u16>>> m_finished;
+
+    std::unique_ptr<Worker> m_worker;
+};
+
+#endif
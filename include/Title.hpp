@@ -5,9 +5,14 @@
 #include <citro2d.h>
 
 #include <FS/Archive.hpp>
+#include <FS/ReadPipeline.hpp>
+#include <TitleSnapshot.hpp>
+#include <Util/Hasher.hpp>
+#include <Util/IconAtlas.hpp>
+#include <Util/InternedPath.hpp>
 #include <Util/Mutex.hpp>
 #include <Util/SMDH.hpp>
-#include <Util/TexWrapper.hpp>
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,15 +27,33 @@ enum Container {
     EXTDATA = 0b10
 };
 
+// files are hashed in blocks of this size so unchanged blocks can skip md5 on rehash
+constexpr u32 HASH_BLOCK_SIZE = 0x10000;
+
+// read size used while hashing, must be a multiple of HASH_BLOCK_SIZE
+constexpr u32 HASH_READ_SIZE = HASH_BLOCK_SIZE * 2;
+static_assert(HASH_READ_SIZE % HASH_BLOCK_SIZE == 0);
+
+struct BlockDigest {
+    // xxh64 of the block
+    u64 checksum;
+    // md5 state after the block, hashing resumes from here if the next block changed
+    u32 state[4];
+};
+
 struct FileInfo {
-    std::u16string nativePath;
-    std::string path;
+    // interned, so copies of the file lists share their path strings and comparing paths is comparing ids
+    InternedPath path;
 
     std::optional<std::string> hash = std::nullopt;
+    HashAlgorithm hashAlgorithm     = HashAlgorithm::MD5;
     u64 size;
 
     bool _shouldUpdateHash = false;
 
+    // only full blocks, the remainder of the file is always hashed, empty unless the algorithm is resumable
+    std::vector<BlockDigest> blocks = {};
+
     bool operator<(const FileInfo& other) const {
         return path < other.path;
     }
@@ -38,15 +61,23 @@ struct FileInfo {
     bool operator==(const FileInfo& other) const {
         return path == other.path &&
                size == other.size &&
-               hash == other.hash;
+               hash == other.hash &&
+               hashAlgorithm == other.hashAlgorithm;
     }
 };
 
 std::string getContainerName(Container container);
 
+namespace TitleCache {
+struct TitleData;
+};
+
 class Title {
 public:
-    Title(u64 id, FS_MediaType mediaType, FS_CardType cardType);
+    // accessStamp is accessStamp() of the installed title, the containers are only probed if it differs from the cached one or is 0
+    Title(u64 id, FS_MediaType mediaType, FS_CardType cardType, u64 accessStamp = 0);
+    // from the title list snapshot, trusts its product code and accessibility instead of asking the services
+    Title(const TitleSnapshot::Entry& entry);
     ~Title();
 
     bool valid() const;
@@ -68,19 +99,47 @@ public:
     std::string shortDescription() const;
     std::string longDescription() const;
 
+    // empty until an icon is set, they're loaded on demand by IconLoader
     C2D_Image* icon();
-
-    std::shared_ptr<Archive> openContainer(Container container) const;
+    bool hasIcon() const;
+    // only from the render thread, an icon can't change while a frame is being drawn
+    void setIcon(std::shared_ptr<IconAtlas::Slot> slot);
+    // tiled icon data from the title cache if possible, otherwise the smdh, empty if neither could be read
+    // safe from any thread, it's only copied into the atlas by setIcon
+    std::vector<u16> loadIcon();
+
+    // a failed open clears the access stamp, so the containers are probed again next start
+    std::shared_ptr<Archive> openContainer(Container container);
     Mutex& containerMutex(Container container);
 
     bool containerAccessible(Container container) const;
 
+    // changes whenever the title is installed again or updated
+    static u64 accessStamp(const AM_TitleEntry& info);
+    // minutes since 2000 the containers were last opened to check if they exist
+    u32 accessCheckedAt() const;
+    // opens both containers again, any that became accessible have their files loaded, true if anything changed
+    bool probeAccessibility();
+
     void resetContainerFiles(Container container);
     void reloadContainerFiles(Container container);
     std::vector<FileInfo> getContainerFiles(Container container) const;
 
     void setContainerFiles(std::vector<FileInfo>& files, Container container);
-    void hashContainer(Container container);
+    // pipeline is reused between containers if given, its buffer size should be a multiple of HASH_BLOCK_SIZE
+    // skipUnchanged keeps the cached hashes without opening the container if every file is hashed with Hasher::preferred() and none are marked for update
+    void hashContainer(Container container, ReadPipeline* pipeline = nullptr, bool skipUnchanged = false);
+
+    // directory walk used by loadContainerFiles, files already in files are kept as is (with their hashes), sorted by path
+    // new files get their size from the directory listing, see DirectoryScanner
+    static std::vector<FileInfo> scanFiles(std::shared_ptr<Archive> archive, const std::vector<FileInfo>& files, std::u16string root = u"/");
+    // hashes every file in place, files that fail to open or read are removed, returns bytes read
+    static u64 hashFiles(std::shared_ptr<Archive> archive, std::vector<FileInfo>& files, ReadPipeline& pipeline, HashAlgorithm hashAlgorithm);
+
+    // marks every file in the container to be rehashed
+    void markContainerChanged(Container container);
+    // minutes since 2000 the container was last fully hashed, 0 if never
+    u32 lastHashed(Container container) const;
 
     Result deleteSecureSaveValue();
 
@@ -94,19 +153,33 @@ private:
     // to be run with a worker in the background
     void loadContainerFiles(Container container, bool cache = true, std::shared_ptr<Archive> archive = nullptr, bool lock = true);
 
-    bool loadSMDHData();
+    // descriptions from the smdh, its icon is copied into titleData if given
+    bool loadSMDHData(TitleCache::TitleData* titleData = nullptr);
+    // title data of the current cache record
+    bool readCachedTitleData(TitleCache::TitleData& titleData);
+
+    // opens both containers to see which exist
+    void probeContainers();
 
     bool loadCache();
-    void saveCache();
+    // false if the title data couldn't be loaded, a failed write is only logged
+    bool saveCache();
 
 private:
     bool m_valid;
-    bool m_saveAccessible;
-    bool m_extdataAccessible;
+    std::atomic<bool> m_saveAccessible;
+    std::atomic<bool> m_extdataAccessible;
+
+    // set if the accessibility came from the snapshot, it's kept over the cached one
+    bool m_accessKnown;
+    std::atomic<u64> m_accessStamp;
+    u32 m_accessCheckedAt;
 
     Mutex m_saveMutex;
     Mutex m_extdataMutex;
     Mutex m_cacheMutex;
+    // m_iconSlot is read by the threads saving the cache while the render thread can replace it
+    Mutex m_iconMutex;
 
     u64 m_id;
     FS_MediaType m_mediaType;
@@ -117,10 +190,13 @@ private:
     std::vector<FileInfo> m_saveFiles;
     std::vector<FileInfo> m_extdataFiles;
 
+    u32 m_saveHashedAt;
+    u32 m_extdataHashedAt;
+
     std::string m_shortDescription;
     std::string m_longDescription;
 
-    std::shared_ptr<TexWrapper> m_tex;
+    std::shared_ptr<IconAtlas::Slot> m_iconSlot;
     C2D_Image m_icon = { nullptr, nullptr };
 
     u8 m_outOfDate;
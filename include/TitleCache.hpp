@@ -0,0 +1,113 @@
+#ifndef __TITLE_CACHE_HPP__
+#define __TITLE_CACHE_HPP__
+
+#include <3ds.h>
+
+#include <Title.hpp>
+#include <Util/Hasher.hpp>
+#include <Util/SMDH.hpp>
+#include <memory>
+#include <vector>
+
+// on disk format of a single title's cache
+// header, title data, file records, block digests, then a string table for paths
+namespace TitleCache {
+constexpr char MAGIC[4] = { 'S', 'S', 'T', 'C' };
+constexpr u16 VERSION   = 7;
+
+struct Header {
+    char magic[4];
+    u16 version;
+    u16 headerSize;
+    // crc32 of everything after the header
+    u32 checksum;
+
+    u32 fileCount;
+    u32 blockCount;
+    u32 stringsSize;
+
+    // from the start of the file
+    u32 titleDataOffset;
+    u32 filesOffset;
+    u32 blocksOffset;
+    u32 stringsOffset;
+
+    // minutes since 2000 each container was last fully hashed, 0 if never, added in version 4
+    u32 saveHashedAt;
+    u32 extdataHashedAt;
+
+    // added in version 6, see Access
+    u64 accessStamp;
+    u32 accessCheckedAt;
+    u8 accessible;
+    u8 reserved[3];
+};
+
+// which containers opened when last probed, lets a title skip opening both archives on every start
+struct Access {
+    // Title::accessStamp of the installed title when probed, 0 to always probe again
+    u64 stamp     = 0;
+    // minutes since 2000
+    u32 checkedAt = 0;
+    // bitmask of Container
+    u8 accessible = 0;
+};
+
+struct TitleData {
+    char shortDescription[sizeof(SMDH::ApplicationTitle::shortDescription) / sizeof(u16)];
+    char longDescription[sizeof(SMDH::ApplicationTitle::longDescription) / sizeof(u16)];
+    // tiled rgb565, rows of 8 pixels high tiles
+    u16 iconData[SMDH::ICON_WIDTH * SMDH::ICON_HEIGHT];
+};
+
+struct FileRecord {
+    u64 size;
+
+    // into the string table, not null terminated
+    u32 pathOffset;
+    u32 pathSize;
+
+    // into the block digests
+    u32 blockStart;
+    u32 blockCount;
+
+    u8 container;
+    u8 hasHash;
+    // digest is Hasher::digestSize bytes of hash, always md5 before version 5
+    u8 hash[16];
+    HashAlgorithm hashAlgorithm;
+    u8 reserved[5];
+};
+
+static_assert(sizeof(Header) == 64);
+static_assert(sizeof(FileRecord) == 48);
+static_assert(sizeof(BlockDigest) == 24);
+// block digests before version 7 were 20 bytes with a crc32 checksum, they're dropped when read
+constexpr size_t LEGACY_BLOCK_DIGEST_SIZE = 20;
+
+struct Contents {
+    std::unique_ptr<TitleData> titleData;
+
+    std::vector<FileInfo> saveFiles;
+    std::vector<FileInfo> extdataFiles;
+
+    u32 saveHashedAt    = 0;
+    u32 extdataHashedAt = 0;
+
+    // zeroed before version 6, so the containers are probed again
+    Access access;
+};
+
+// true if data starts with the binary magic, otherwise it could be a legacy text cache
+bool isBinary(const std::vector<u8>& data);
+
+std::vector<u8> encode(const TitleData& titleData, const std::vector<FileInfo>& saveFiles, const std::vector<FileInfo>& extdataFiles, u32 saveHashedAt, u32 extdataHashedAt, const Access& access = {});
+// false if the data is truncated, corrupt or a different version, version 3 is read with no hash times
+bool decode(const std::vector<u8>& data, Contents& out);
+// only the descriptions and icon, skips parsing the file records
+bool decodeTitleData(const std::vector<u8>& data, TitleData& out);
+// text format written by versions 001 and 002, only read for migration
+bool decodeLegacy(const std::vector<u8>& data, Contents& out);
+}; // namespace TitleCache
+
+#endif
@@ -4,26 +4,42 @@
 #include <3ds.h>
 
 #include <Title.hpp>
+#include <TitleOrder.hpp>
+#include <TitleSnapshot.hpp>
 #include <Util/Mutex.hpp>
 #include <array>
 #include <atomic>
+#include <deque>
 #include <list>
+#include <map>
 #include <memory>
+#include <optional>
 #include <rocket.hpp>
 #include <stack>
 #include <vector>
 
-#include <Util/CondVar.hpp>
+#include <Util/CardEvents.hpp>
 #include <Util/Mutex.hpp>
 #include <Util/ScopedService.hpp>
 #include <Util/Worker.hpp>
+#include <Util/WorkerPool.hpp>
+
+// a published title list, never changed after so readers can hold onto it without locking
+struct TitleList {
+    // increases with every list published
+    u64 version = 0;
+    std::vector<std::shared_ptr<Title>> titles;
+};
 
 class TitleLoader {
 public:
-    TitleLoader();
+    // card events can be replaced to drive the card watcher without the services
+    // orderFactory is called at the start of every load, titles are loaded, shown and hashed in its order
+    TitleLoader(std::unique_ptr<CardEventSource> cardEvents = CardEventSource::create(), TitleOrderFactory orderFactory = TitleOrder::recentlyPlayed());
     ~TitleLoader();
 
     void reloadTitles();
+    // called from the load, card and request workers, restarts are serialized
     void reloadHashes();
 
     size_t totalTitles() const;
@@ -31,7 +47,8 @@ public:
 
     bool isLoadingTitles() const;
 
-    std::vector<std::shared_ptr<Title>> titles();
+    // the latest published list, never null, grab it once per frame instead of per use
+    std::shared_ptr<const TitleList> titles() const;
 
 public:
     rocket::thread_safe_signal<void(const size_t&)> titlesLoadedChangedSignal;
@@ -39,16 +56,48 @@ public:
     rocket::thread_safe_signal<void(const std::shared_ptr<Title>&, const Container&)> titleHashedSignal;
 
 private:
+    struct LoadEntry;
+
     bool loadGameCardTitle();
     void loadSDTitles(u32 numTitles = 0);
+    // constructs the entries with the load pool, valid titles are appended to m_titles in m_order
+    void loadQueuedTitles(std::vector<LoadEntry> entries);
+
+    // false if there's no usable snapshot, otherwise publishes its titles without asking AM
+    bool loadSnapshotTitles();
+    // applies the differences between the loaded sd titles and the AM title list, true if anything changed
+    bool reconcileSDTitles();
+    // only written if different from the last snapshot saved
+    void saveSnapshot();
+
+    // swaps in a copy of m_titles for readers, expects m_titlesMutex to be held
+    void publishTitles();
+    // the one read for the current load, read here if no load has run yet
+    std::shared_ptr<const PlayHistory> playHistory() const;
 
     void cardWorkerMain();
+    void stopCardWorker();
     void loadWorkerMain();
+    // constructs titles from the load queue until empty, run by the load worker and the load pool
+    void loadQueueMain();
     void hashWorkerMain();
+    // pulls containers from the hash queue until empty, run by the hash worker and the hash pool
+    void hashQueueMain();
 
 private:
+    // only used by the workers changing the list, everything else reads the published list
     Mutex m_titlesMutex;
     std::vector<std::shared_ptr<Title>> m_titles;
+    std::atomic<std::shared_ptr<const TitleList>> m_publishedTitles;
+    // the same titles by id and media type, a game card can have the same id as an installed title
+    std::map<std::pair<u64, FS_MediaType>, std::shared_ptr<Title>> m_titleIndex;
+
+    struct HashEntry {
+        std::shared_ptr<Title> title;
+        Container container;
+        // not played since last hashed, see Title::hashContainer
+        bool skipUnchanged;
+    };
 
     struct TitleEntry {
         u64 id;
@@ -56,19 +105,62 @@ private:
         FS_CardType cardType;
     };
 
+    struct LoadEntry {
+        u64 id;
+        // titles from the snapshot skip the service calls
+        std::optional<TitleSnapshot::Entry> snapshot;
+        // see Title::accessStamp, 0 if unknown
+        u64 accessStamp;
+        bool done;
+        // null if invalid, only kept until published
+        std::shared_ptr<Title> title;
+    };
+
     size_t m_totalTitles               = 0;
     std::atomic<size_t> m_titlesLoaded = 0;
 
+    // cleared once the list can be shown, the load worker keeps reconciling the snapshot after
+    std::atomic<bool> m_loadingTitles = false;
+    // set once the whole list has loaded, reloads after only apply the differences with AM
+    bool m_titlesComplete;
+
+    // sd titles without a save or extdata, kept so reloads and the snapshot can skip them
+    std::vector<u64> m_skippedTitles;
+    // minutes since 2000, skipped titles are rechecked if they ran after this
+    u32 m_skippedCheckedAt;
+    std::vector<TitleSnapshot::Entry> m_savedSnapshot;
+
+    TitleOrderFactory m_orderFactory;
+    // both replaced at the start of every load, the hash worker can be reading them
+    std::atomic<std::shared_ptr<const TitleOrder>> m_order;
+    // read once per load and shared by the order, reconciling and hashing, nothing else can run while the app does
+    std::atomic<std::shared_ptr<const PlayHistory>> m_history;
+
     // title id for last pinged game cartridge
     u64 m_lastCardID;
 
     // watches for changes in the game card
+    std::unique_ptr<CardEventSource> m_cardEvents;
     std::unique_ptr<Worker> m_cardWorker;
 
     std::unique_ptr<Worker> m_loaderWorker;
+    // title construction is mostly waiting on services, so these share the load worker's core
+    std::unique_ptr<WorkerPool> m_loadPool;
+
+    // titles are published to m_titles in queue order as the front entries finish
+    Mutex m_loadQueueMutex;
+    std::vector<LoadEntry> m_loadQueue;
+    size_t m_nextLoad;
+    size_t m_nextPublish;
+    // held while the hash worker is stopped and started, Worker isn't safe to restart from two threads at once
+    Mutex m_hashRestartMutex;
     std::unique_ptr<Worker> m_hashWorker;
+    // helpers for the hash worker on the other cores
+    std::unique_ptr<WorkerPool> m_hashPool;
+
+    Mutex m_hashQueueMutex;
+    std::deque<HashEntry> m_hashQueue;
 
-    ConditionVariable m_condVar;
     Services::AM p_AM;
 };
 
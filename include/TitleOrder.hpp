@@ -0,0 +1,46 @@
+#ifndef __TITLE_ORDER_HPP__
+#define __TITLE_ORDER_HPP__
+
+#include <3ds.h>
+
+#include <Util/PlayHistory.hpp>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class TitleOrder;
+// called at the start of every title load with the play history read for it, so the order can follow what was played since the last one
+using TitleOrderFactory = std::function<std::shared_ptr<const TitleOrder>(const PlayHistory& history)>;
+
+// which titles are loaded, shown and hashed first, immutable once made so any thread can use it
+class TitleOrder {
+public:
+    // most recently played in the load's history first, lastSelected goes before everything
+    static TitleOrderFactory recentlyPlayed(u64 lastSelected = 0);
+    virtual ~TitleOrder() = default;
+
+    // higher first
+    virtual u64 priority(u64 id) const = 0;
+
+    // stable so titles with the same priority keep their order, key gives each item's title id
+    template<typename T, typename Key>
+    void sort(std::vector<T>& items, Key key) const {
+        std::stable_sort(items.begin(), items.end(), [this, &key](const T& a, const T& b) { return priority(key(a)) > priority(key(b)); });
+    }
+};
+
+// most recently played first, titles the log doesn't have keep their AM order after them
+class RecentlyPlayedOrder : public TitleOrder {
+public:
+    // the history can be made from a recorded log, see PlayHistory
+    RecentlyPlayedOrder(const PlayHistory& history, u64 lastSelected = 0);
+
+    u64 priority(u64 id) const override;
+
+private:
+    PlayHistory m_history;
+    u64 m_lastSelected;
+};
+
+#endif
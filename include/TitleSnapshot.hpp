@@ -0,0 +1,49 @@
+#ifndef __TITLE_SNAPSHOT_HPP__
+#define __TITLE_SNAPSHOT_HPP__
+
+#include <3ds.h>
+
+#include <vector>
+
+// on disk format of the sd title list from the last run, lets the title list be shown before AM is asked
+// header then fixed size entries in title list order, descriptions and icons stay in each title's own cache record
+namespace TitleSnapshot {
+constexpr char MAGIC[4] = { 'S', 'S', 'T', 'L' };
+constexpr u16 VERSION   = 1;
+
+// can't be a title id, see Cache
+constexpr u64 CACHE_KEY = 0xFFFFFFFF00000001ULL;
+
+struct Header {
+    char magic[4];
+    u16 version;
+    u16 headerSize;
+    // crc32 of everything after the header
+    u32 checksum;
+
+    u32 entryCount;
+    u32 entrySize;
+    // minutes since 2000, titles without a save are only rechecked if played after this
+    u32 savedAt;
+};
+
+struct Entry {
+    u64 id;
+    u8 mediaType;
+    // bitmask of Container, 0 if the title had neither a save or extdata
+    u8 accessible;
+    // bitmask of Container
+    u8 outOfDate;
+    u8 reserved[5];
+    char productCode[16];
+};
+
+static_assert(sizeof(Header) == 24);
+static_assert(sizeof(Entry) == 32);
+
+std::vector<u8> encode(const std::vector<Entry>& entries, u32 savedAt);
+// false if the data is truncated, corrupt or a different version
+bool decode(const std::vector<u8>& data, std::vector<Entry>& out, u32& savedAt);
+}; // namespace TitleSnapshot
+
+#endif
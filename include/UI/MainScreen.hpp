@@ -2,6 +2,7 @@
 #define __MAIN_SCREEN_HPP__
 
 #include <Client.hpp>
+#include <IconLoader.hpp>
 #include <TitleLoader.hpp>
 #include <UI/Screen.hpp>
 #include <UI/SettingsScreen.hpp>
@@ -12,7 +13,8 @@
 class MainScreen : public Screen, rocket::trackable {
 public:
     MainScreen(std::shared_ptr<Config> config, std::shared_ptr<TitleLoader> loader, std::shared_ptr<Client> client);
-    ~MainScreen() = default;
+    // keeps the selected title for the next start
+    ~MainScreen();
 
     void update();
 
@@ -25,10 +27,12 @@ private:
     void onClientRequestFailed(std::string status);
 
 private:
-    void TitleIcon(std::shared_ptr<Title> title, float width, float height, Clay_BorderElementConfig border);
+    void TitleIcon(const std::shared_ptr<Title>& title, float width, float height, Clay_BorderElementConfig border);
 
     void GridLayout();
     void ListLayout();
+    // icons for the visible rows, the selected title and a few rows either side, run after scrollToCurrent
+    void requestIcons(const std::vector<std::shared_ptr<Title>>& titles);
 
 private:
     void handleButtonHover(Clay_ElementId elementId, Clay_PointerData pointerData);
@@ -45,7 +49,11 @@ private:
     std::shared_ptr<TitleLoader> m_loader;
     std::shared_ptr<Client> m_client;
 
+    // taken once per frame in update, the loader can publish a new list at any time
+    std::shared_ptr<const TitleList> m_titles;
+
     std::unique_ptr<SettingsScreen> m_settingsScreen;
+    std::unique_ptr<IconLoader> m_iconLoader;
     size_t m_selectedTitle = 0;
 
     u16 m_rows        = 0;
@@ -61,6 +69,7 @@ private:
     bool m_okActive = false;
 
     size_t m_prevLoadedTitles = std::numeric_limits<size_t>::max();
+    u64 m_titleTextsVersion   = std::numeric_limits<u64>::max();
 
     std::string m_loadedText, m_yesNoText, m_okText;
     Clay_String m_loadedString = CLAY_STRING(""), m_yesNoString = CLAY_STRING(""), m_okString = CLAY_STRING("");
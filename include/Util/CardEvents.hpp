@@ -0,0 +1,32 @@
+#ifndef __CARD_EVENTS_HPP__
+#define __CARD_EVENTS_HPP__
+
+#include <3ds.h>
+
+#include <memory>
+
+// what wakes the game card watcher, the watcher only waits on this so it can be driven without the services
+class CardEventSource {
+public:
+    enum Event {
+        // nothing happened in time, the watcher checks the card anyway
+        TIMEOUT,
+        INSERTED,
+        REMOVED,
+        // from wake(), the watcher checks if it should exit
+        WOKEN
+    };
+
+    // srv card notifications, only times out if they can't be subscribed to
+    static std::unique_ptr<CardEventSource> create();
+    virtual ~CardEventSource() = default;
+
+    // false if no events will arrive and the card has to be polled
+    virtual bool available() const = 0;
+
+    // blocks until an event or timeoutNS has passed
+    virtual Event wait(s64 timeoutNS) = 0;
+    virtual void wake() = 0;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef __HASHER_HPP__
+#define __HASHER_HPP__
+
+#include <3ds.h>
+
+#include <memory>
+#include <string>
+
+// stored in the title cache, values must not change
+enum class HashAlgorithm : u8 {
+    MD5   = 0,
+    XXH64 = 1
+};
+
+// streaming file digest, algorithms are picked by what the server supports
+class Hasher {
+public:
+    static std::unique_ptr<Hasher> create(HashAlgorithm algorithm);
+    virtual ~Hasher() = default;
+
+    virtual HashAlgorithm algorithm() const = 0;
+
+    virtual void update(const u8* data, u32 size) = 0;
+    // lowercase hex, the hasher can't be updated afterwards
+    virtual std::string finalize() = 0;
+
+    // md5 can resume from the state after any whole number of 64 byte blocks, see Title::hashContainer
+    virtual bool resumable() const { return false; }
+    virtual void saveState(u32 (&)[4]) const {}
+    virtual void restoreState(const u32 (&)[4], u64) {}
+
+public:
+    // name used by the server api
+    static const char* name(HashAlgorithm algorithm);
+    // false if the name isn't a known algorithm
+    static bool fromName(const char* name, HashAlgorithm& out);
+
+    // in bytes, hex digests are twice this
+    static u8 digestSize(HashAlgorithm algorithm);
+
+    // algorithm new digests are made with, set from the server's capabilities
+    static HashAlgorithm preferred();
+    static void setPreferred(HashAlgorithm algorithm);
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef __ICON_ATLAS_HPP__
+#define __ICON_ATLAS_HPP__
+
+#include <3ds.h>
+#include <citro2d.h>
+
+#include <Util/Mutex.hpp>
+#include <Util/SMDH.hpp>
+#include <Util/TexWrapper.hpp>
+#include <memory>
+#include <vector>
+
+// packs title icons into a few large textures instead of a mostly empty 64x64 texture each
+// icons in the same page share a texture so the grid rarely has to rebind one
+class IconAtlas {
+public:
+    static constexpr u16 PAGE_WIDTH  = 512;
+    static constexpr u16 PAGE_HEIGHT = 512;
+
+    static constexpr u16 SLOT_COLUMNS   = PAGE_WIDTH / SMDH::ICON_WIDTH;
+    static constexpr u16 SLOT_ROWS      = PAGE_HEIGHT / SMDH::ICON_HEIGHT;
+    static constexpr u16 SLOTS_PER_PAGE = SLOT_COLUMNS * SLOT_ROWS;
+
+    // linear memory per page, rgb565
+    static constexpr size_t PAGE_SIZE = PAGE_WIDTH * PAGE_HEIGHT * sizeof(u16);
+
+    // slots are placed on tile boundaries so icons can be copied a row of tiles at a time
+    static_assert(SMDH::ICON_WIDTH % 8 == 0 && SMDH::ICON_HEIGHT % 8 == 0);
+
+    struct Page {
+        std::shared_ptr<TexWrapper> tex;
+
+        // slots are released from whichever thread drops the last reference
+        Mutex mutex;
+        // lowest index last so each page fills in order
+        std::vector<u16> freeSlots;
+    };
+
+    // an icon's place in a page, freed for reuse once the last reference is dropped
+    class Slot {
+    public:
+        ~Slot();
+
+        // only valid while the slot is held
+        C2D_Image image();
+        // tiled like SMDH::bigIconData
+        void read(u16* iconData) const;
+
+    protected:
+        Slot(std::shared_ptr<Page> page, u16 index) noexcept;
+
+    private:
+        friend class IconAtlas;
+
+        // top left tile of the slot
+        u16* data() const;
+
+        std::shared_ptr<Page> m_page;
+        u16 m_index;
+        Tex3DS_SubTexture m_subtex;
+    };
+
+    IconAtlas();
+
+    // iconData is tiled like SMDH::bigIconData, null if a new page couldn't be allocated
+    // only from the render thread, a page can be read by the frame being drawn
+    std::shared_ptr<Slot> add(const u16* iconData);
+    // frees pages without any slots in use
+    void trim();
+
+    size_t pageCount() const;
+
+private:
+    std::shared_ptr<Page> createPage();
+
+private:
+    std::vector<std::shared_ptr<Page>> m_pages;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef __INTERNED_PATH_HPP__
+#define __INTERNED_PATH_HPP__
+
+#include <3ds.h>
+
+#include <string>
+#include <string_view>
+
+// a path stored once in a global table, copies only hold its id
+// the same path from the cache, the server or a scan is the same id, so FileInfo doesn't carry its own utf8 and utf16 strings
+// the table only grows, paths stay valid for as long as the app runs
+class InternedPath {
+public:
+    // the empty path
+    InternedPath();
+    explicit InternedPath(std::string_view utf8);
+
+    static InternedPath fromUTF16(const std::u16string& utf16);
+
+    u32 id() const;
+
+    // points into the table, never moves or changes, looked up without locking
+    std::string_view utf8() const;
+    // converted on every call, for opening files
+    std::u16string utf16() const;
+
+    bool operator==(const InternedPath& other) const;
+    // by path not id, so the order doesn't depend on which paths were seen first
+    bool operator<(const InternedPath& other) const;
+
+private:
+    u32 m_id;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __PLAY_HISTORY_HPP__
+#define __PLAY_HISTORY_HPP__
+
+#include <3ds.h>
+#include <ptmplays.h>
+#include <unordered_map>
+
+// when titles last ran according to the ptm play event log, times are minutes since 2000-01-01 like the log
+class PlayHistory {
+public:
+    // events are read from the service in batches of this size
+    static constexpr s32 READ_BATCH = 0x800;
+
+    // reads the whole log from ptm:plays, invalid if the service isn't accessible
+    PlayHistory();
+    // from already read events, oldest first, full if the log has wrapped and lost older events
+    PlayHistory(const PtmPlayEvent* events, size_t count, bool full);
+
+    bool valid() const;
+
+    // true if the title could have run at or after minutes, anything the log can't rule out counts as played
+    bool playedSince(u64 id, u32 minutes) const;
+    // latest event for the title, 0 if it isn't in the log
+    u32 lastPlayed(u64 id) const;
+
+    // now, in the same units as the log
+    static u32 currentMinutes();
+
+private:
+    void addEvents(const PtmPlayEvent* events, size_t count);
+
+    bool m_valid;
+    bool m_full;
+
+    u32 m_oldestEvent;
+    u32 m_lastTimeChange;
+
+    std::unordered_map<u64, u32> m_lastPlayed;
+};
+
+#endif
@@ -6,7 +6,6 @@
 #include <memory>
 #include <string>
 
-#include <Util/TexWrapper.hpp>
 #include <citro2d.h>
 
 class SMDH {
@@ -61,7 +60,8 @@ public:
     const ApplicationTitle& applicationTitle(u8 index) const;
     const Settings& settings() const;
 
-    std::shared_ptr<TexWrapper> bigTex();
+    // tiled like the texture data, ICON_WIDTH x ICON_HEIGHT
+    const u16* bigIconData() const;
 
     static void copyImageData(const u16* src, u16 srcWidth, u16 srcHeight, u16* dst, u16 dstWidth, u16 dstHeight);
 
@@ -69,7 +69,6 @@ private:
     bool m_valid;
 
     Data m_data;
-    std::shared_ptr<TexWrapper> m_bigTex;
 };
 
 #endif
\ No newline at end of file
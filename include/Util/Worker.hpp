@@ -6,6 +6,7 @@
 #include <atomic>
 #include <functional>
 #include <string>
+#include <vector>
 
 // was going to name it thread, but that would conflict with internal types
 class Worker {
@@ -21,6 +22,11 @@ public:
 
     Worker(const Worker&) = delete;
 
+    // cores this process can create threads on, SYSCORE requires APT_SetAppCpuTimeLimit
+    static std::vector<Processor> availableProcessors();
+    // the core the calling thread is running on
+    static Processor currentProcessor();
+
     // higher priority is better, defaults to one higher than the current thread
     Worker(std::function<void(Worker*)> workerFunction = nullptr, int priorityOffset = 1, size_t stackSize = 0x1000, Processor processor = DEFAULT);
     ~Worker();
@@ -28,7 +34,8 @@ public:
     void setWorkerFunc(std::function<void(Worker*)> func = nullptr);
 
     bool running() const;
-    void start();
+    // false if the thread couldn't be created (e.g. core not available)
+    bool start();
 
     void waitForExit();
     // sets waitingForExit, but does not block
@@ -0,0 +1,33 @@
+#ifndef __WORKER_POOL_HPP__
+#define __WORKER_POOL_HPP__
+
+#include <3ds.h>
+#include <Util/Worker.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// runs the same function on one worker per processor, the function should pull its work from a shared queue
+class WorkerPool {
+public:
+    WorkerPool(const WorkerPool&) = delete;
+
+    WorkerPool(std::function<void(Worker*)> workerFunction, int priorityOffset = 1, size_t stackSize = 0x1000, std::vector<Worker::Processor> processors = Worker::availableProcessors());
+    ~WorkerPool();
+
+    size_t size() const;
+    // true if any worker is running
+    bool running() const;
+
+    // workers that fail to start (e.g. core not available) are skipped, returns how many started
+    size_t start();
+
+    void waitForExit();
+    // sets waitingForExit on all workers, but does not block
+    void signalShouldExit();
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+#endif
@@ -24,10 +24,10 @@ void Application::tryUpdateClientURL(bool processing) {
     m_pendingURL.clear();
 }
 
-bool filesEqual(std::vector<FileInfo> a, std::vector<FileInfo> b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+bool filesEqual(const std::vector<FileInfo>& a, const std::vector<FileInfo>& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
 void Application::checkTitleOutOfDate(std::shared_ptr<Title> title, Container) {
+    // keeps the last known state (e.g. from the title snapshot) until the server's info is loaded
     if(!m_client->cachedTitleInfoLoaded()) {
-        title->setOutOfDate(0);
         return;
     }
 
@@ -54,7 +54,8 @@ void Application::checkTitleOutOfDate(std::shared_ptr<Title> title, Container) {
 }
 
 void Application::checkTitlesOutOfDate() {
-    for(auto title : m_loader->titles()) {
+    const std::shared_ptr<const TitleList> list = m_loader->titles();
+    for(auto title : list->titles) {
         checkTitleOutOfDate(title);
     }
 }
@@ -124,7 +125,11 @@ Application::Application(bool consoleEnabled, gfxScreen_t consoleScreen)
     initClay();
 
     m_config = std::make_shared<Config>();
-    m_loader = std::make_shared<TitleLoader>();
+    // before the loader starts hashing
+    Hasher::setPreferred(m_config->hashAlgorithm()->value());
+
+    // the title selected last time is loaded and shown first
+    m_loader = std::make_shared<TitleLoader>(CardEventSource::create(), TitleOrder::recentlyPlayed(m_config->lastTitle()->value()));
     m_client = std::make_shared<Client>();
 
     updateURL();
@@ -133,6 +138,15 @@ Application::Application(bool consoleEnabled, gfxScreen_t consoleScreen)
     m_connections += {
         m_config->serverURL()->changedEmptySignal.connect([this, config = m_config, client = m_client]() noexcept { updateURL(); }),
         m_config->serverPort()->changedEmptySignal.connect([this, config = m_config, client = m_client]() noexcept { updateURL(); }),
+        // digests in the old algorithm no longer match the server's, rehash everything (the loader hashes once it's done anyway)
+        m_config->hashAlgorithm()->changedSignal.connect([loader = m_loader](const HashAlgorithm& algorithm) noexcept {
+            Hasher::setPreferred(algorithm);
+            if(!loader->isLoadingTitles()) {
+                loader->reloadHashes();
+            }
+        }),
+
+        m_client->hashAlgorithmChangedSignal.connect([config = m_config](const HashAlgorithm& algorithm) noexcept { config->hashAlgorithm()->setValue(algorithm); }),
 
         m_client->networkQueueChangedSignal.connect([this, client = m_client](const size_t&, const bool& processing) noexcept { tryUpdateClientURL(processing); }),
         m_client->titleCacheChangedSignal.connect([this, loader = m_loader, client = m_client]() noexcept { checkTitlesOutOfDate(); }),
@@ -153,6 +167,10 @@ Application::~Application() {
 
     m_client->stopQueueWorker();
 
+#ifdef DEBUG
+    m_benchmark.reset();
+#endif
+
     m_mainScreen.reset();
     m_client.reset();
     m_loader.reset();
@@ -252,6 +270,19 @@ void Application::update() {
         Logger::logProfiler();
         return;
     }
+
+    if((kDown & KEY_L || kHeld & KEY_L) && kDown & KEY_SELECT) {
+        if(!m_consoleEnabled) {
+            setConsole(true, m_consoleScreen);
+        }
+
+        if(m_benchmark == nullptr) {
+            m_benchmark = std::make_unique<Benchmark>();
+        }
+
+        m_benchmark->start();
+        return;
+    }
 #endif
 }
 
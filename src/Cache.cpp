@@ -1,32 +1,370 @@
 #include <Cache.hpp>
+#include <Debug/Logger.hpp>
+#include <Debug/Profiler.hpp>
 #include <FS/Archive.hpp>
+#include <algorithm>
+#include <string.h>
+#include <zlib.h>
+
+// titles are loaded from several threads, only one should open the cache
+static Mutex s_cacheMutex;
+static std::shared_ptr<Cache> s_cache;
+void Cache::close() {
+    auto lock = s_cacheMutex.lock();
+    s_cache.reset();
+}
+
+std::shared_ptr<Cache> Cache::instance() {
+    auto lock = s_cacheMutex.lock();
+    if(s_cache != nullptr) {
+        return s_cache;
+    }
+
+    struct make_shared_enabler : public Cache {
+        make_shared_enabler()
+            : Cache() {}
+    };
+    s_cache = std::make_shared<make_shared_enabler>();
+
+    return s_cache;
+}
 
-// TODO: need to work out how cache will function, mostly a stub for now
 Cache::Cache()
-    : m_valid(false) {
+    : m_valid(false)
+    , m_slotCount(0) {
     std::shared_ptr<Archive> sdmc = Archive::sdmc();
     if(sdmc == nullptr || !sdmc->valid() || !sdmc->mkdir(u"/3ds/" EXE_NAME, 0, true)) {
+        Logger::error("Cache", "Failed to open data directory");
         return;
     }
 
     m_cacheFile = sdmc->openFile(u"/3ds/" EXE_NAME "/cache", FS_OPEN_READ | FS_OPEN_WRITE | FS_OPEN_CREATE, 0);
     if(m_cacheFile == nullptr || !m_cacheFile->valid()) {
+        Logger::error("Cache", "Failed to open cache file");
         return;
     }
 
     m_mapFile = sdmc->openFile(u"/3ds/" EXE_NAME "/cache.map", FS_OPEN_READ | FS_OPEN_WRITE | FS_OPEN_CREATE, 0);
     if(m_mapFile == nullptr || !m_mapFile->valid()) {
+        Logger::error("Cache", "Failed to open cache map");
+        return;
+    }
+
+    if(!loadMap() && !reset()) {
+        Logger::error("Cache", "Failed to reset cache");
         return;
     }
 
     m_valid = true;
 }
 
-Cache::~Cache() {
-}
+Cache::~Cache() {}
 
 bool Cache::valid() const { return m_valid; }
+u32 Cache::recordCapacity(u32 length) { return (length + length / 8 + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1); }
+
+bool Cache::reset() {
+    m_records.clear();
+    m_freeSlots.clear();
+    m_slotCount = 0;
+
+    MapHeader header = { .version = MAP_VERSION, .entrySize = sizeof(MapEntry) };
+    memcpy(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+
+    return m_cacheFile->setSize(0) && m_mapFile->setSize(sizeof(MapHeader)) &&
+           m_mapFile->write(&header, sizeof(MapHeader), 0, FS_WRITE_FLUSH) == sizeof(MapHeader);
+}
+
+bool Cache::loadMap() {
+    PROFILE_SCOPE("Load Cache Map");
+
+    const u64 mapSize   = m_mapFile->size();
+    const u64 cacheSize = m_cacheFile->size();
+    if(mapSize == U64_MAX || cacheSize == U64_MAX || mapSize < sizeof(MapHeader) || mapSize > UINT32_MAX) {
+        return false;
+    }
+
+    // whole index in one read
+    std::vector<u8> data(mapSize);
+    if(m_mapFile->read(data.data(), static_cast<u32>(mapSize), 0) != mapSize) {
+        return false;
+    }
+
+    MapHeader header;
+    memcpy(&header, data.data(), sizeof(MapHeader));
+    if(memcmp(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0 || header.version != MAP_VERSION || header.entrySize != sizeof(MapEntry)) {
+        Logger::warn("Cache", "Cache map is an unknown version, resetting");
+        return false;
+    }
+
+    m_slotCount = static_cast<u32>((mapSize - sizeof(MapHeader)) / sizeof(MapEntry));
+    for(u32 slot = 0; slot < m_slotCount; slot++) {
+        MapEntry entry;
+        memcpy(&entry, data.data() + sizeof(MapHeader) + slot * sizeof(MapEntry), sizeof(MapEntry));
+
+        // entries past the end of the cache file are from an interrupted write
+        if(entry.key == 0 || entry.length > entry.capacity || static_cast<u64>(entry.offset) + entry.length > cacheSize || m_records.contains(entry.key)) {
+            if(entry.key != 0) {
+                clearSlot(slot);
+            }
+
+            m_freeSlots.push_back(slot);
+            continue;
+        }
+
+        m_records[entry.key] = {
+            .slot     = slot,
+            .offset   = entry.offset,
+            .length   = entry.length,
+            .capacity = entry.capacity,
+            .checksum = entry.checksum
+        };
+    }
+
+    Logger::info("Cache", "Loaded {} records, {} bytes free", m_records.size(), freeSpace());
+    return true;
+}
+
+bool Cache::writeEntry(u64 key, const Record& record) {
+    MapEntry entry = {
+        .key      = key,
+        .offset   = record.offset,
+        .length   = record.length,
+        .capacity = record.capacity,
+        .checksum = record.checksum
+    };
 
-void Cache::updateTitle(std::shared_ptr<Title> title) {
-    (void)title;
-}
\ No newline at end of file
+    return m_mapFile->write(&entry, sizeof(MapEntry), sizeof(MapHeader) + record.slot * sizeof(MapEntry), FS_WRITE_FLUSH) == sizeof(MapEntry);
+}
+
+bool Cache::clearSlot(u32 slot) {
+    MapEntry entry = {};
+    return m_mapFile->write(&entry, sizeof(MapEntry), sizeof(MapHeader) + slot * sizeof(MapEntry), FS_WRITE_FLUSH) == sizeof(MapEntry);
+}
+
+u32 Cache::takeSlot() {
+    if(m_freeSlots.empty()) {
+        return m_slotCount++;
+    }
+
+    u32 slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+
+    return slot;
+}
+
+u64 Cache::allocate(u32 capacity) {
+    std::vector<std::pair<u64, u64>> ranges;
+    ranges.reserve(m_records.size());
+
+    for(const auto& [key, record] : m_records) {
+        ranges.push_back({ record.offset, static_cast<u64>(record.offset) + record.capacity });
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+
+    u64 end = 0;
+    for(const auto& range : ranges) {
+        if(range.first >= end + capacity) {
+            return end;
+        }
+
+        end = std::max(end, range.second);
+    }
+
+    return end;
+}
+
+u64 Cache::dataEnd() const {
+    u64 end = 0;
+    for(const auto& [key, record] : m_records) {
+        end = std::max(end, static_cast<u64>(record.offset) + record.capacity);
+    }
+
+    return end;
+}
+
+u64 Cache::freeSpace() const {
+    u64 used = 0;
+    for(const auto& [key, record] : m_records) {
+        used += record.capacity;
+    }
+
+    return dataEnd() - used;
+}
+
+bool Cache::contains(u64 key) {
+    auto lock = m_mutex.lock();
+    return m_valid && m_records.contains(key);
+}
+
+bool Cache::read(u64 key, std::vector<u8>& data) {
+    auto lock = m_mutex.lock();
+    if(!m_valid) return false;
+
+    auto it = m_records.find(key);
+    if(it == m_records.end()) {
+        return false;
+    }
+
+    const Record& record = it->second;
+
+    data.resize(record.length);
+    if(m_cacheFile->read(data.data(), record.length, record.offset) != record.length) {
+        Logger::warn("Cache", "Failed to read record {:X}", key);
+        return false;
+    }
+
+    if(crc32(0, data.data(), record.length) != record.checksum) {
+        Logger::warn("Cache", "Record {:X} is corrupt, removing", key);
+
+        clearSlot(record.slot);
+        m_freeSlots.push_back(record.slot);
+        m_records.erase(it);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool Cache::write(u64 key, const std::vector<u8>& data) {
+    auto lock = m_mutex.lock();
+    if(!m_valid || key == 0 || data.size() > UINT32_MAX) return false;
+
+    PROFILE_SCOPE("Cache Write");
+
+    const u32 length   = static_cast<u32>(data.size());
+    const u32 checksum = crc32(0, data.data(), length);
+
+    Record record;
+    auto it = m_records.find(key);
+    if(it != m_records.end() && length <= it->second.capacity) {
+        // in place, a torn write is caught by the checksum
+        record = it->second;
+    }
+    else {
+        // new location, the old one is only freed once the entry points away from it
+        record.slot     = it != m_records.end() ? it->second.slot : takeSlot();
+        record.capacity = recordCapacity(length);
+        record.offset   = static_cast<u32>(allocate(record.capacity));
+    }
+
+    record.length   = length;
+    record.checksum = checksum;
+
+    const bool newSlot = it == m_records.end();
+    if(m_cacheFile->write(data.data(), length, record.offset, FS_WRITE_FLUSH) != length) {
+        Logger::warn("Cache", "Failed to write record {:X}", key);
+        Logger::warn("Cache", m_cacheFile->lastResult());
+
+        goto failed;
+    }
+
+    if(!writeEntry(key, record)) {
+        Logger::warn("Cache", "Failed to write map entry {:X}", key);
+        Logger::warn("Cache", m_mapFile->lastResult());
+
+        goto failed;
+    }
+
+    m_records[key] = record;
+    compactIfNeeded();
+
+    return true;
+
+failed:
+    if(newSlot) {
+        m_freeSlots.push_back(record.slot);
+    }
+
+    return false;
+}
+
+bool Cache::remove(u64 key) {
+    auto lock = m_mutex.lock();
+    if(!m_valid) return false;
+
+    auto it = m_records.find(key);
+    if(it == m_records.end()) {
+        return true;
+    }
+
+    if(!clearSlot(it->second.slot)) {
+        return false;
+    }
+
+    m_freeSlots.push_back(it->second.slot);
+    m_records.erase(it);
+
+    compactIfNeeded();
+    return true;
+}
+
+void Cache::compactIfNeeded() {
+    u64 free = freeSpace();
+    if(free > COMPACT_MIN_FREE && free > (dataEnd() - free) / 2) {
+        compactLocked();
+    }
+}
+
+bool Cache::compact() {
+    auto lock = m_mutex.lock();
+    if(!m_valid) return false;
+
+    return compactLocked();
+}
+
+bool Cache::compactLocked() {
+    PROFILE_SCOPE("Compact Cache");
+
+    std::vector<std::pair<u32, u64>> order;
+    order.reserve(m_records.size());
+
+    for(const auto& [key, record] : m_records) {
+        order.push_back({ record.offset, key });
+    }
+
+    std::sort(order.begin(), order.end());
+
+    // records only ever move down, each is read fully before being rewritten so overlaps are safe
+    bool success = true;
+    u64 end      = 0;
+    std::vector<u8> data;
+
+    for(const auto& [offset, key] : order) {
+        Record& record = m_records[key];
+        if(record.offset == end) {
+            end += record.capacity;
+            continue;
+        }
+
+        data.resize(record.length);
+        if(m_cacheFile->read(data.data(), record.length, record.offset) != record.length) {
+            success = false;
+            end     = std::max(end, static_cast<u64>(record.offset) + record.capacity);
+
+            continue;
+        }
+
+        Record moved = record;
+        moved.offset = static_cast<u32>(end);
+
+        if(m_cacheFile->write(data.data(), record.length, moved.offset, FS_WRITE_FLUSH) != record.length || !writeEntry(key, moved)) {
+            Logger::warn("Cache", "Failed to move record {:X}", key);
+            success = false;
+
+            // the entry may still point at the old offset, make sure nothing else gets placed over it
+            end = std::max(end, static_cast<u64>(record.offset) + record.capacity);
+            continue;
+        }
+
+        record = moved;
+        end += record.capacity;
+    }
+
+    m_cacheFile->setSize(end);
+    Logger::info("Cache", "Compacted cache to {} bytes", end);
+
+    return success;
+}
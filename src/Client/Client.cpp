@@ -82,6 +82,7 @@ Client::Client(std::string url)
     , m_requestWorker(std::make_unique<Worker>([this](Worker*) { queueWorkerMain(); }, 6, 0x10000))
     , m_serverOnline(false)
     , m_titleInfoCached(false)
+    , m_hashAlgorithm(HashAlgorithm::MD5)
     , m_processRequests(true)
     , m_processingQueueRequest(false)
     , m_showRequestProgress(true)
@@ -102,6 +103,7 @@ Client::~Client() {
     titleInfoChangedSignal.clear();
     requestStatusChangedSignal.clear();
     requestFailedSignal.clear();
+    hashAlgorithmChangedSignal.clear();
 
     if(!m_valid) {
         return;
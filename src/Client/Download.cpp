@@ -1,11 +1,14 @@
 #include <Client.hpp>
 #include <Config.hpp>
 #include <Debug/Logger.hpp>
+#include <FS/ArchivePool.hpp>
+#include <FS/BufferedFile.hpp>
 #include <FS/Directory.hpp>
 #include <FS/File.hpp>
 #include <Util/CURLEasy.hpp>
 #include <Util/Defines.hpp>
 #include <Util/StringUtil.hpp>
+#include <algorithm>
 #include <format>
 #include <list>
 #include <rapidjson/document.h>
@@ -39,6 +42,9 @@ Result Client::beginDownload(std::shared_ptr<Title> title, Container container,
 
     std::vector<FileInfo> files = title->getContainerFiles(container);
 
+    // hashes sent and received are all in this algorithm
+    const HashAlgorithm hashAlgorithm = m_hashAlgorithm;
+
     rapidjson::StringBuffer buf;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
 
@@ -50,6 +56,12 @@ Result Client::beginDownload(std::shared_ptr<Title> title, Container container,
         writer.Key("container");
         writer.String(getContainerName(container).c_str());
 
+        // left out for md5 so requests to servers without negotiation are unchanged
+        if(hashAlgorithm != HashAlgorithm::MD5) {
+            writer.Key("hashAlgorithm");
+            writer.String(Hasher::name(hashAlgorithm));
+        }
+
         writer.Key("existingFiles");
         writer.StartArray();
 
@@ -57,14 +69,14 @@ Result Client::beginDownload(std::shared_ptr<Title> title, Container container,
             writer.StartObject();
 
             writer.Key("path");
-            writer.String(info.path.c_str());
+            writer.String(info.path.utf8().data(), static_cast<rapidjson::SizeType>(info.path.utf8().size()));
 
             writer.Key("size");
             writer.Uint64(info.size);
 
             writer.Key("hash");
 
-            if(info.hash.has_value() || !info._shouldUpdateHash) {
+            if(info.hash.has_value() && info.hashAlgorithm == hashAlgorithm) {
                 writer.String(info.hash->c_str());
             }
             else {
@@ -158,6 +170,8 @@ Result Client::beginDownload(std::shared_ptr<Title> title, Container container,
             .action = DownloadAction::actionValue(std::string(file["action"].GetString(), file["action"].GetStringLength())),
             .size   = size,
             .hash   = hash,
+
+            .hashAlgorithm = hashAlgorithm,
         });
     }
 
@@ -165,10 +179,11 @@ Result Client::beginDownload(std::shared_ptr<Title> title, Container container,
     return RL_SUCCESS;
 }
 
-Result Client::downloadFile(const std::string& ticket, std::shared_ptr<File> file, const std::string& path) {
+Result Client::downloadFile(const std::string& ticket, BufferedFileWriter& writer, std::shared_ptr<File> file, const std::string& path, u64 size) {
     Logger::info("Download File", "Ticket: {} - Downloading {}", ticket, path);
 
-    u64 fileWriteOffset = 0;
+    // the previous file was already written out when it finished
+    writer.open(file);
     CURLEasy easy;
 
     easy.setOptions({
@@ -182,18 +197,16 @@ Result Client::downloadFile(const std::string& ticket, std::shared_ptr<File> fil
         },
 
         .write = WriteOptions{
-            .bufferSize = 0x100,
-            .callback   = [this, file, path, &fileWriteOffset](char* data, size_t dataSize) {
-                u64 wrote = file->write(reinterpret_cast<u8*>(data), dataSize, fileWriteOffset);
-                if(wrote == 0 || wrote == U64_MAX) {
-                    Logger::warn("Download File", "Invalid write: {} size: {}", path, wrote);
+            // curl's default, the writer coalesces these into much larger fs writes
+            .bufferSize = CURL_MAX_WRITE_SIZE,
+            .callback   = [this, path, &writer](char* data, size_t dataSize) {
+                if(!writer.write(std::span<const u8>(reinterpret_cast<const u8*>(data), dataSize))) {
+                    Logger::warn("Download File", "Invalid write: {} size: {}", path, dataSize);
                     return static_cast<size_t>(CURL_READFUNC_ABORT);
                 }
 
-                m_progressCurrent += wrote;
-                fileWriteOffset += wrote;
-
-                return static_cast<size_t>(wrote);
+                m_progressCurrent += dataSize;
+                return dataSize;
             },
         },
     });
@@ -210,9 +223,15 @@ Result Client::downloadFile(const std::string& ticket, std::shared_ptr<File> fil
         return invalidStatusCodeError();
     }
 
-    if(file->size() > fileWriteOffset) {
-        // zero out file if more data to write
-        file->write(std::vector<u8>(file->size() - fileWriteOffset, 0), fileWriteOffset);
+    // zero out file if more data to write, through the same buffer so nothing the size of the file is allocated
+    if(size > writer.tell() && !writer.writeZeros(size - writer.tell())) {
+        Logger::warn("Download File", "Failed to zero: {}", path);
+        return file->lastResult();
+    }
+
+    if(!writer.flush()) {
+        Logger::warn("Download File", "Failed to write: {}", path);
+        return file->lastResult();
     }
 
     return RL_SUCCESS;
@@ -281,16 +300,19 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
         }
     }
 
+    // one buffer for every file, small files don't each allocate their own
+    BufferedFileWriter writer(nullptr);
+
     std::vector<FileInfo> newFiles;
     for(const auto& fileAction : fileActions) {
         switch(fileAction.action) {
         case DownloadAction::KEEP: {
             newFiles.push_back(FileInfo{
-                .nativePath = StringUtil::fromUTF8(fileAction.path),
-                .path       = fileAction.path,
+                .path = InternedPath(fileAction.path),
 
-                .hash = fileAction.hash,
-                .size = fileAction.size.value_or(1),
+                .hash          = fileAction.hash,
+                .hashAlgorithm = fileAction.hashAlgorithm,
+                .size          = fileAction.size.value_or(1),
 
                 ._shouldUpdateHash = fileAction.hash.has_value(),
             });
@@ -323,13 +345,14 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
                 }
             }
 
-            if(R_FAILED(res = downloadFile(ticket, file, fileAction.path))) {
+            if(R_FAILED(res = downloadFile(ticket, writer, file, fileAction.path, fileAction.size.value_or(1)))) {
                 Logger::warn("Download Replace", "Failed to download file: {}", fileAction.path);
 
                 goto cancelExit;
             }
 
-            if(!file->flush()) {
+            // saves are flushed all at once by the commit, extdata has no commit so each file is flushed as it's finished
+            if(container != Container::SAVE && !file->flush()) {
                 Logger::warn("Download Replace", "Failed to flush file: {}", fileAction.path);
 
                 res = file->lastResult();
@@ -341,11 +364,11 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
             }
 
             newFiles.push_back(FileInfo{
-                .nativePath = StringUtil::fromUTF8(fileAction.path),
-                .path       = fileAction.path,
+                .path = InternedPath(fileAction.path),
 
-                .hash = fileAction.hash,
-                .size = fileAction.size.value_or(1),
+                .hash          = fileAction.hash,
+                .hashAlgorithm = fileAction.hashAlgorithm,
+                .size          = fileAction.size.value_or(1),
 
                 ._shouldUpdateHash = fileAction.hash.has_value(),
             });
@@ -391,12 +414,13 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
                 goto cancelExit;
             }
 
-            if(R_FAILED(res = downloadFile(ticket, file, fileAction.path))) {
+            if(R_FAILED(res = downloadFile(ticket, writer, file, fileAction.path, fileAction.size.value_or(1)))) {
                 Logger::warn("Download Create", "Failed to set download file: {}", fileAction.path);
                 goto cancelExit;
             }
 
-            if(!file->flush()) {
+            // saves are flushed all at once by the commit, extdata has no commit so each file is flushed as it's finished
+            if(container != Container::SAVE && !file->flush()) {
                 Logger::warn("Download Create", "Failed to flush file: {}", fileAction.path);
 
                 res = file->lastResult();
@@ -408,11 +432,11 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
             }
 
             newFiles.push_back(FileInfo{
-                .nativePath = StringUtil::fromUTF8(fileAction.path),
-                .path       = fileAction.path,
+                .path = InternedPath(fileAction.path),
 
-                .hash = fileAction.hash,
-                .size = fileAction.size.value_or(1),
+                .hash          = fileAction.hash,
+                .hashAlgorithm = fileAction.hashAlgorithm,
+                .size          = fileAction.size.value_or(1),
 
                 ._shouldUpdateHash = fileAction.hash.has_value(),
             });
@@ -435,11 +459,21 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
 
     if(R_FAILED(res)) {
     cancelExit:
+        // the failed file's buffered bytes would otherwise be written into the abandoned archive when the writer is destroyed
+        writer.discard();
+
+        // nothing was committed, the pooled archive is closed so the partial writes are thrown away instead of seen by the next use
+        archive.reset();
+        ArchivePool::instance()->invalidate(title->id(), title->mediaType());
+
         endDownload(ticket);
 
         return res;
     }
 
+    // drops the last file, nothing should be left open for the commit
+    writer.open(nullptr);
+
     if(container == Container::SAVE) {
         if(!archive->commitSaveData()) {
             Logger::warn("Download Save", "Failed to commit save data");
@@ -453,7 +487,9 @@ Result Client::download(std::shared_ptr<Title> title, Container container) {
         }
     }
 
+    // the files were rewritten and the save committed, later uses open the container fresh
     archive.reset();
+    ArchivePool::instance()->invalidate(title->id(), title->mediaType());
     lock.release();
 
     if(reloadFiles) {
@@ -11,24 +11,89 @@
 #include <rapidjson/schema.h>
 #include <rapidjson/stringbuffer.h>
 
+// most preferred first, md5 is supported by every server
+constexpr HashAlgorithm clientHashAlgorithms[] = { HashAlgorithm::XXH64, HashAlgorithm::MD5 };
+
 constexpr std::optional<FileInfo> getFileInfo(const rapidjson::Value& val) {
     if(
         NotType(val, "path", String) ||
         NotType(val, "size", Uint64) ||
-        NotType(val, "hash", String)
+        NotType(val, "hash", String) ||
+        (Exists(val, "hashAlgorithm") && NotType(val, "hashAlgorithm", String))
     ) {
         return std::nullopt;
     }
 
+    // servers from before negotiation only send md5
+    HashAlgorithm hashAlgorithm = HashAlgorithm::MD5;
+    if(Exists(val, "hashAlgorithm") && !Hasher::fromName(val["hashAlgorithm"].GetString(), hashAlgorithm)) {
+        return std::nullopt;
+    }
+
     return FileInfo{
-        .nativePath = u"/" + StringUtil::fromUTF8(val["path"].GetString()),
-        .path       = std::format("/{}", val["path"].GetString()),
+        .path = InternedPath(std::format("/{}", val["path"].GetString())),
 
-        .hash = val["hash"].GetString(),
-        .size = val["size"].GetUint64(),
+        .hash          = val["hash"].GetString(),
+        .hashAlgorithm = hashAlgorithm,
+        .size          = val["size"].GetUint64(),
     };
 }
 
+HashAlgorithm Client::hashAlgorithm() const { return m_hashAlgorithm; }
+Result Client::loadCapabilities() {
+    rapidjson::Document document;
+    CURLEasy easy(CURLEasyOptions{
+        .url    = std::format("{}/v1/capabilities", url()),
+        .method = CURLEasyMethod::GET,
+
+        .trackProgress          = true,
+        .customProgressFunction = [this](curl_off_t, curl_off_t, curl_off_t, curl_off_t) noexcept -> int {
+            return m_requestWorker->waitingForExit();
+        },
+        .connectTimeout = 2,
+
+        .write = WriteOptions{
+            .callback = [&document](char* buf, size_t bufSize) noexcept -> size_t {
+                rapidjson::StringStream stream(buf);
+                document.ParseStream(stream);
+
+                return bufSize;
+            },
+        },
+    });
+
+    CURLcode code = easy.perform();
+    if(code != CURLE_OK) {
+        return performFailError();
+    }
+
+    HashAlgorithm algorithm = HashAlgorithm::MD5;
+    if(easy.statusCode() != 200) {
+        Logger::info("Capabilities", "Server has no capabilities (status code {}), using md5", easy.statusCode());
+    }
+    else if(document.HasParseError() || !document.IsObject() || NotType(document, "hashAlgorithms", Array)) {
+        Logger::warn("Capabilities", "Invalid document, using md5");
+    }
+    else {
+        const auto serverAlgorithms = document["hashAlgorithms"].GetArray();
+        for(HashAlgorithm candidate : clientHashAlgorithms) {
+            if(std::any_of(serverAlgorithms.begin(), serverAlgorithms.end(), [candidate](const rapidjson::Value& name) { return name.IsString() && strcmp(name.GetString(), Hasher::name(candidate)) == 0; })) {
+                algorithm = candidate;
+                break;
+            }
+        }
+    }
+
+    if(m_hashAlgorithm != algorithm) {
+        Logger::info("Capabilities", "Hash algorithm changed to {}", Hasher::name(algorithm));
+    }
+
+    m_hashAlgorithm = algorithm;
+    hashAlgorithmChangedSignal(algorithm);
+
+    return RL_SUCCESS;
+}
+
 bool Client::cachedTitleInfoLoaded() const { return m_titleInfoCached; }
 std::unordered_map<u64, TitleInfo> Client::cachedTitleInfo() {
     auto lock = m_cachedTitleInfoMutex.lock();
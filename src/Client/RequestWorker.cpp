@@ -68,7 +68,9 @@ void Client::queueWorkerMain() {
         }
 
         if(!serverOnline()) {
-            loadTitleInfoCache();
+            if(R_SUCCEEDED(loadCapabilities())) {
+                loadTitleInfoCache();
+            }
 
             if(!serverOnline() || m_requestWorker->waitingForExit()) {
                 svcSleepThread(50 * static_cast<u64>(1e+6));
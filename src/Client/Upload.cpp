@@ -4,6 +4,7 @@
 #include <Client.hpp>
 #include <Config.hpp>
 #include <Debug/Logger.hpp>
+#include <FS/BufferedFile.hpp>
 #include <FS/File.hpp>
 #include <Util/CURLEasy.hpp>
 #include <Util/Defines.hpp>
@@ -24,6 +25,9 @@ Result Client::beginUpload(std::shared_ptr<Title> title, Container container, st
         return noFilesUploadError();
     }
 
+    // files hashed with another algorithm are sent without a hash so the server asks for them
+    const HashAlgorithm hashAlgorithm = m_hashAlgorithm;
+
     rapidjson::StringBuffer buf;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
 
@@ -35,6 +39,12 @@ Result Client::beginUpload(std::shared_ptr<Title> title, Container container, st
         writer.Key("container");
         writer.String(getContainerName(container).c_str());
 
+        // left out for md5 so requests to servers without negotiation are unchanged
+        if(hashAlgorithm != HashAlgorithm::MD5) {
+            writer.Key("hashAlgorithm");
+            writer.String(Hasher::name(hashAlgorithm));
+        }
+
         writer.Key("files");
         writer.StartArray();
 
@@ -42,14 +52,14 @@ Result Client::beginUpload(std::shared_ptr<Title> title, Container container, st
             writer.StartObject();
 
             writer.Key("path");
-            writer.String(info.path.c_str());
+            writer.String(info.path.utf8().data(), static_cast<rapidjson::SizeType>(info.path.utf8().size()));
 
             writer.Key("size");
             writer.Uint64(info.size);
 
             writer.Key("hash");
 
-            if(info.hash.has_value() && !info._shouldUpdateHash) {
+            if(info.hash.has_value() && info.hashAlgorithm == hashAlgorithm && !info._shouldUpdateHash) {
                 writer.String(info.hash->c_str());
             }
             else {
@@ -144,7 +154,8 @@ Result Client::uploadFile(const std::string& ticket, std::shared_ptr<File> file,
         return MAKERESULT(RL_PERMANENT, RS_INVALIDARG, RM_APPLICATION, RD_INVALID_POINTER);
     }
 
-    u64 fileReadOffset = 0;
+    // curl asks for a buffer at a time, the file is read ahead in larger blocks
+    BufferedFileReader reader(file);
     CURLEasy easy;
 
     easy.setOptions({
@@ -159,16 +170,16 @@ Result Client::uploadFile(const std::string& ticket, std::shared_ptr<File> file,
         },
 
         .read = ReadOptions{
-            .bufferSize = 0x100,
+            // the smallest upload buffer curl allows, each callback is a copy out of the reader and a progress update
+            .bufferSize = CURL_MAX_WRITE_SIZE,
             .dataSize   = static_cast<long>(fileSize),
-            .callback   = [this, file, path, &fileSize, &fileReadOffset](char* data, size_t dataSize) {
-                u64 read = file->read(reinterpret_cast<u8*>(data), dataSize, fileReadOffset);
+            .callback   = [this, path, &reader](char* data, size_t dataSize) {
+                u64 read = reader.read(std::span<u8>(reinterpret_cast<u8*>(data), dataSize));
                 if(read == 0 || read == U64_MAX) {
                     Logger::warn("Upload File", "Invalid read: {} size: {}", path, read);
                     return static_cast<size_t>(CURL_READFUNC_ABORT);
                 }
 
-                fileReadOffset += read;
                 m_progressCurrent += read;
                 requestProgressChangedSignal(m_progressCurrent, m_progressMax);
 
@@ -1,25 +1,34 @@
 #include <Config.hpp>
 #include <Debug/Logger.hpp>
+#include <charconv>
 #include <format>
 
 const std::string defaultURL = "http://example.com";
 const u16 defaultPort        = 8000;
 const Layout defaultLayout   = GRID;
 
+const HashAlgorithm defaultHashAlgorithm = HashAlgorithm::MD5;
+
 Config::Config()
     : m_serverURL(std::make_shared<Option<std::string>>("Server URL", defaultURL))
     , m_serverPort(std::make_shared<Option<u16>>("Server Port", defaultPort))
-    , m_layout(std::make_shared<Option<Layout>>("Layout", defaultLayout)) {
+    , m_layout(std::make_shared<Option<Layout>>("Layout", defaultLayout))
+    , m_hashAlgorithm(std::make_shared<Option<HashAlgorithm>>("Hash Algorithm", defaultHashAlgorithm))
+    , m_lastTitle(std::make_shared<Option<u64>>("Last Title", 0)) {
     load();
 
     m_serverURL->changedEmptySignal.connect<&Config::save>(this);
     m_serverPort->changedEmptySignal.connect<&Config::save>(this);
     m_layout->changedEmptySignal.connect<&Config::save>(this);
+    m_hashAlgorithm->changedEmptySignal.connect<&Config::save>(this);
+    m_lastTitle->changedEmptySignal.connect<&Config::save>(this);
 }
 
 std::shared_ptr<Option<std::string>> Config::serverURL() { return m_serverURL; }
 std::shared_ptr<Option<u16>> Config::serverPort() { return m_serverPort; }
 std::shared_ptr<Option<Layout>> Config::layout() { return m_layout; }
+std::shared_ptr<Option<HashAlgorithm>> Config::hashAlgorithm() { return m_hashAlgorithm; }
+std::shared_ptr<Option<u64>> Config::lastTitle() { return m_lastTitle; }
 
 void Config::load() {
     auto file = openFile(FS_OPEN_READ);
@@ -31,6 +40,10 @@ void Config::load() {
     std::string url       = file->readLine(0);
     std::string portStr   = file->readLine(url.size() + 1);
     std::string layoutStr = file->readLine(url.size() + portStr.size() + 2);
+    // missing in configs from before negotiation
+    std::string hashStr = file->readLine(url.size() + portStr.size() + layoutStr.size() + 3);
+    // missing in configs from before the title order
+    std::string lastTitleStr = file->readLine(url.size() + portStr.size() + layoutStr.size() + hashStr.size() + 4);
 
     if(url.empty() || portStr.empty() || layoutStr.empty()) {
         Logger::warn("Config", "Config file invalid entries");
@@ -56,6 +69,16 @@ void Config::load() {
     if(layoutStr.size() == 1 && isdigit(layoutStr[0])) {
         m_layout->setValue(static_cast<Layout>(layoutStr[0] - '0'));
     }
+
+    HashAlgorithm hashAlgorithm;
+    if(Hasher::fromName(hashStr.c_str(), hashAlgorithm)) {
+        m_hashAlgorithm->setValue(hashAlgorithm);
+    }
+
+    u64 lastTitle;
+    if(!lastTitleStr.empty() && std::from_chars(lastTitleStr.data(), lastTitleStr.data() + lastTitleStr.size(), lastTitle, 16).ec == std::errc()) {
+        m_lastTitle->setValue(lastTitle);
+    }
 }
 
 void Config::save() {
@@ -70,6 +93,8 @@ void Config::save() {
     writeBuf += m_serverURL->value() + "\n";
     writeBuf += std::format("{}", m_serverPort->value()) + "\n";
     writeBuf += std::format("{}", static_cast<int>(m_layout->value())) + "\n";
+    writeBuf += std::string(Hasher::name(m_hashAlgorithm->value())) + "\n";
+    writeBuf += std::format("{:X}", m_lastTitle->value()) + "\n";
     if(writeBuf.empty()) {
         file->setSize(1);
         file->write({ '\n' }, 0, FS_WRITE_FLUSH);
@@ -0,0 +1,252 @@
+#include <Cache.hpp>
+#include <Debug/Benchmark.hpp>
+#include <Debug/Logger.hpp>
+#include <FS/File.hpp>
+#include <Title.hpp>
+#include <TitleCache.hpp>
+#include <Util/StringUtil.hpp>
+#include <format>
+
+#define BENCHMARK_ROOT u"/3ds/" EXE_NAME "/benchmark"
+
+// can't be a title id, those always have a nonzero high half below this
+constexpr u64 benchmarkCacheKey = 0xFFFFFFFF00000000ULL;
+
+constexpr u32 writeChunkSize = 0x10000;
+
+constexpr HashAlgorithm benchmarkAlgorithms[] = { HashAlgorithm::MD5, HashAlgorithm::XXH64 };
+
+const std::vector<Benchmark::TreeProfile>& Benchmark::defaultProfiles() {
+    static const std::vector<TreeProfile> profiles = {
+        { .name = "tiny", .fileCount = 1024, .fileSize = 0x80, .width = 16, .depth = 1 },
+        { .name = "huge", .fileCount = 3, .fileSize = 0x800000, .width = 1, .depth = 0 },
+        { .name = "deep", .fileCount = 128, .fileSize = 0x1000, .width = 2, .depth = 24 },
+        { .name = "pokemon", .fileCount = 1, .fileSize = 0x100000, .width = 1, .depth = 0 },
+    };
+
+    return profiles;
+}
+
+Benchmark::Benchmark(std::vector<TreeProfile> profiles)
+    : m_profiles(profiles)
+    , m_sdmc(Archive::sdmc())
+    , m_worker(std::make_unique<Worker>([this](Worker*) { workerMain(); }, -1, 0x4000, Worker::APPCORE)) {}
+
+Benchmark::~Benchmark() { m_worker->waitForExit(); }
+
+bool Benchmark::running() const { return m_worker->running(); }
+void Benchmark::start() {
+    if(running()) {
+        return;
+    }
+
+    m_worker->waitForExit();
+    m_worker->start();
+}
+
+std::u16string Benchmark::treeRoot(const TreeProfile& profile) const { return BENCHMARK_ROOT u"/" + StringUtil::fromUTF8(profile.name); }
+
+bool Benchmark::generate(const TreeProfile& profile) {
+    // the marker is outside the tree so it isn't walked or hashed
+    const std::u16string root   = treeRoot(profile);
+    const std::u16string marker = root + u".done";
+    if(m_sdmc->hasFile(marker)) {
+        return true;
+    }
+
+    Logger::info("Benchmark", "Generating {} ({} files of {} bytes)", profile.name, profile.fileCount, profile.fileSize);
+
+    // xorshift so the contents don't compress or repeat between blocks
+    u32 seed = 0x9E3779B9;
+    std::vector<u32> chunk(writeChunkSize / sizeof(u32));
+
+    for(u32 i = 0; i < profile.fileCount; i++) {
+        if(m_worker->waitingForExit()) {
+            return false;
+        }
+
+        std::u16string dir = root + StringUtil::fromUTF8(std::format("/b{}", i % profile.width));
+        const u32 level    = (i / profile.width) % (profile.depth + 1);
+        for(u32 d = 0; d < level; d++) {
+            dir += StringUtil::fromUTF8(std::format("/d{}", d));
+        }
+
+        if(!m_sdmc->mkdir(dir, 0, true)) {
+            Logger::warn("Benchmark", "Failed to create {}", StringUtil::toUTF8(dir));
+            return false;
+        }
+
+        std::shared_ptr<File> file = m_sdmc->openFile(dir + StringUtil::fromUTF8(std::format("/f{}.bin", i)), FS_OPEN_WRITE | FS_OPEN_CREATE, 0);
+        if(file == nullptr || !file->valid() || !file->setSize(profile.fileSize)) {
+            Logger::warn("Benchmark", "Failed to create file {} in {}", i, StringUtil::toUTF8(dir));
+            return false;
+        }
+
+        for(u32 offset = 0; offset < profile.fileSize; offset += writeChunkSize) {
+            for(u32& word : chunk) {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                word = seed;
+            }
+
+            const u32 size = std::min(writeChunkSize, profile.fileSize - offset);
+            if(file->write(chunk.data(), size, offset, 0) != size) {
+                Logger::warn("Benchmark", "Failed to write file {} in {}", i, StringUtil::toUTF8(dir));
+                return false;
+            }
+        }
+    }
+
+    std::shared_ptr<File> markerFile = m_sdmc->openFile(marker, FS_OPEN_WRITE | FS_OPEN_CREATE, 0);
+    return markerFile != nullptr && markerFile->valid();
+}
+
+bool Benchmark::run(const TreeProfile& profile, TreeResult& result) {
+    result = {};
+
+    u64 start = svcGetSystemTick();
+
+    const std::vector<FileInfo> files = Title::scanFiles(m_sdmc, {}, treeRoot(profile));
+    result.walk                       = svcGetSystemTick() - start;
+    result.files                      = files.size();
+
+    if(files.size() != profile.fileCount) {
+        Logger::warn("Benchmark", "{}: found {} of {} files", profile.name, files.size(), profile.fileCount);
+        return false;
+    }
+
+    ReadPipeline pipeline(HASH_READ_SIZE);
+    std::vector<FileInfo> md5Files;
+
+    for(HashAlgorithm algorithm : benchmarkAlgorithms) {
+        std::vector<FileInfo> hashed = files;
+
+        start                                   = svcGetSystemTick();
+        result.bytes                            = Title::hashFiles(m_sdmc, hashed, pipeline, algorithm);
+        result.hash[static_cast<u8>(algorithm)] = svcGetSystemTick() - start;
+
+        if(algorithm == HashAlgorithm::MD5) {
+            md5Files = std::move(hashed);
+        }
+    }
+
+    start = svcGetSystemTick();
+    Title::hashFiles(m_sdmc, md5Files, pipeline, HashAlgorithm::MD5);
+    result.rehash = svcGetSystemTick() - start;
+
+    AlignedBuffer buffer(HASH_READ_SIZE);
+    u64 reads = 0;
+
+    start = svcGetSystemTick();
+    if(readFiles(files, nullptr, result.vectorAllocations) == U64_MAX) {
+        return false;
+    }
+
+    result.vectorRead = svcGetSystemTick() - start;
+
+    start = svcGetSystemTick();
+    if(!buffer.valid() || readFiles(files, &buffer, reads) == U64_MAX) {
+        return false;
+    }
+
+    result.spanRead = svcGetSystemTick() - start;
+
+    std::shared_ptr<Cache> cache = Cache::instance();
+    if(cache == nullptr || !cache->valid()) {
+        return true;
+    }
+
+    // the whole save path including encoding, same as Title::saveCache
+    const std::unique_ptr<TitleCache::TitleData> titleData = std::make_unique<TitleCache::TitleData>();
+    TitleCache::Contents contents;
+    std::vector<u8> data;
+
+    start = svcGetSystemTick();
+    cache->write(benchmarkCacheKey, TitleCache::encode(*titleData, md5Files, {}, 0, 0));
+    result.cacheWrite = svcGetSystemTick() - start;
+
+    start = svcGetSystemTick();
+    if(!cache->read(benchmarkCacheKey, data) || !TitleCache::decode(data, contents) || contents.saveFiles.size() != md5Files.size()) {
+        Logger::warn("Benchmark", "{}: cache round trip failed", profile.name);
+    }
+
+    result.cacheRead = svcGetSystemTick() - start;
+    cache->remove(benchmarkCacheKey);
+
+    return true;
+}
+
+u64 Benchmark::readFiles(const std::vector<FileInfo>& files, AlignedBuffer* buffer, u64& reads) {
+    u64 total = 0;
+    reads     = 0;
+
+    for(const FileInfo& info : files) {
+        std::shared_ptr<File> file = m_sdmc->openFile(info.path.utf16(), FS_OPEN_READ, 0);
+        if(file == nullptr || !file->valid()) {
+            return U64_MAX;
+        }
+
+        u64 offset = 0;
+        while(true) {
+            u64 read = buffer != nullptr ? file->read(buffer->span(), offset) : file->read(HASH_READ_SIZE, offset).size();
+            reads++;
+
+            if(read == U64_MAX || R_FAILED(file->lastResult())) {
+                return U64_MAX;
+            }
+
+            offset += read;
+            if(read < HASH_READ_SIZE) {
+                break;
+            }
+        }
+
+        total += offset;
+    }
+
+    return total;
+}
+
+void Benchmark::logResult(const TreeProfile& profile, const TreeResult& result) const {
+    // 268 ticks per microsecond, bytes per microsecond is MB/s
+    auto ms   = [](u64 ticks) { return ticks / 268000.0f; };
+    auto mbps = [&result](u64 ticks) { return ticks == 0 ? 0.0f : result.bytes / (ticks / 268.0f); };
+
+    Logger::info("Benchmark", "{}: {} files, {} bytes, walk {:.2f}ms", profile.name, result.files, result.bytes, ms(result.walk));
+    for(HashAlgorithm algorithm : benchmarkAlgorithms) {
+        const u64 ticks = result.hash[static_cast<u8>(algorithm)];
+        Logger::info("Benchmark", "{}: {} {:.2f}ms ({:.2f} MB/s)", profile.name, Hasher::name(algorithm), ms(ticks), mbps(ticks));
+    }
+
+    Logger::info("Benchmark", "{}: md5 unchanged rehash {:.2f}ms ({:.2f} MB/s)", profile.name, ms(result.rehash), mbps(result.rehash));
+
+    const float allocationsPerMB = result.bytes == 0 ? 0.0f : result.vectorAllocations / (result.bytes / static_cast<float>(0x100000));
+    Logger::info("Benchmark", "{}: vector read {:.2f}ms ({:.2f} MB/s, {} allocations, {:.1f} per MB)", profile.name, ms(result.vectorRead), mbps(result.vectorRead), result.vectorAllocations, allocationsPerMB);
+    Logger::info("Benchmark", "{}: span read {:.2f}ms ({:.2f} MB/s, 1 allocation)", profile.name, ms(result.spanRead), mbps(result.spanRead));
+    Logger::info("Benchmark", "{}: cache write {:.2f}ms, read {:.2f}ms", profile.name, ms(result.cacheWrite), ms(result.cacheRead));
+}
+
+void Benchmark::workerMain() {
+    if(m_sdmc == nullptr || !m_sdmc->valid()) {
+        Logger::error("Benchmark", "SD card not accessible");
+        return;
+    }
+
+    Logger::info("Benchmark", "Running {} trees, titles hashing in the background will skew results", m_profiles.size());
+    for(const TreeProfile& profile : m_profiles) {
+        if(m_worker->waitingForExit()) {
+            return;
+        }
+
+        TreeResult result;
+        if(!generate(profile) || !run(profile, result)) {
+            Logger::warn("Benchmark", "{}: skipped", profile.name);
+            continue;
+        }
+
+        logResult(profile, result);
+    }
+
+    Logger::info("Benchmark", "Done");
+}
@@ -1,7 +1,9 @@
+#include <Cache.hpp>
 #include <Debug/LeakViewerApplication.hpp>
 #include <Debug/Logger.hpp>
 #include <Debug/Profiler.hpp>
 #include <FS/Archive.hpp>
+#include <FS/ArchivePool.hpp>
 #include <Theme.hpp>
 #include <Util/ClayDefines.hpp>
 
@@ -21,9 +23,11 @@ void LeakViewerApplication::initClay() {
 }
 
 void LeakViewerApplication::initLeakList() {
-    // prevent profiler & sdmc from showing up on leak list
+    // prevent profiler, cache, pooled archives & sdmc from showing up on leak list
     Profiler::reset();
     Logger::closeLogFile();
+    Cache::close();
+    ArchivePool::close();
     Archive::closeSDMC();
 
     m_leakBegin          = cloneCurrentList();
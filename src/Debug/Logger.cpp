@@ -33,14 +33,16 @@ struct RenameEntry {
     std::u16string newName;
 };
 
-bool Logger::s_dirInitialized        = false;
-bool Logger::s_dirExists             = false;
-Mutex Logger::s_fileMutex            = Mutex();
-std::shared_ptr<File> Logger::s_file = nullptr;
+bool Logger::s_dirInitialized                        = false;
+bool Logger::s_dirExists                             = false;
+Mutex Logger::s_fileMutex                            = Mutex();
+std::shared_ptr<File> Logger::s_file                 = nullptr;
+std::unique_ptr<BufferedFileWriter> Logger::s_writer = nullptr;
 
 void Logger::closeLogFile() {
     auto lock = s_fileMutex.lock();
 
+    s_writer.reset();
     s_file.reset();
     s_dirExists      = false;
     s_dirInitialized = false;
@@ -72,14 +74,17 @@ std::shared_ptr<File> Logger::openLogFile() {
         }
 
         RenameEntry renames[maxLogs - 1];
-        std::shared_ptr<Directory> dir = sdmc->openDirectory(u"/3ds/" EXE_NAME "/logs");
+        // deleted once the directory has been read, not while it's being read
+        std::vector<std::u16string> deletes;
 
-        for(const auto& entry : *dir) {
-            if(!entry->isFile()) {
+        DirectoryReader dir(sdmc, u"/3ds/" EXE_NAME "/logs");
+
+        for(const DirectoryEntryView& entry : dir) {
+            if(!entry.isFile()) {
                 continue;
             }
 
-            const std::u16string& name = entry->name();
+            std::u16string_view name = entry.name();
             if(!name.starts_with(u"log.") || !name.ends_with(u".txt")) {
                 continue;
             }
@@ -88,36 +93,41 @@ std::shared_ptr<File> Logger::openLogFile() {
                 renames[0] = RenameEntry{
                     .doRename = true,
 
-                    .oldName = entry->path(),
-                    .newName = entry->prefix() + u"log.2.txt"
+                    .oldName = entry.path(),
+                    .newName = entry.prefix() + u"log.2.txt"
                 };
             }
             else {
                 size_t numOffset   = strlen("log.");
                 char16_t logNumber = name[numOffset];
 
-                std::u16string after = name.substr(numOffset + 1);
+                std::u16string_view after = name.substr(numOffset + 1);
                 if(logNumber < u'1' || logNumber > u'9' || after != u".txt") {
                     continue;
                 }
                 else if(logNumber - u'0' >= maxLogs) {
-                    sdmc->deleteFile(entry->path());
+                    deletes.push_back(entry.path());
                     continue;
                 }
 
-                std::u16string newName = entry->prefix() + u"log.";
+                std::u16string newName = entry.prefix() + u"log.";
                 newName += logNumber + 1;
                 newName += u".txt";
 
                 renames[(logNumber - '0') - 1] = RenameEntry{
                     .doRename = true,
 
-                    .oldName = entry->path(),
+                    .oldName = entry.path(),
                     .newName = newName
                 };
             }
         }
 
+        dir.close();
+        for(const std::u16string& path : deletes) {
+            sdmc->deleteFile(path);
+        }
+
         for(u8 i = maxLogs - 2; i != UINT8_MAX; i--) {
             RenameEntry entry = renames[i];
             if(entry.doRename) {
@@ -131,6 +141,14 @@ std::shared_ptr<File> Logger::openLogFile() {
         s_file = nullptr;
     }
 
+    const u64 size = s_file != nullptr ? s_file->size() : U64_MAX;
+    if(size == U64_MAX) {
+        s_file = nullptr;
+        return nullptr;
+    }
+
+    // messages are small, a few lines is enough
+    s_writer = std::make_unique<BufferedFileWriter>(s_file, size, 0x1000);
     return s_file;
 }
 
@@ -146,17 +164,16 @@ void Logger::fileLogMessage(const std::string& message) {
         return;
     }
 
-    u32 size = file->size();
-    if(size == UINT32_MAX || !file->setSize(size + message.size())) {
-        return;
+    // written out every message so nothing is lost if the app crashes, the buffer only saves the size and resize calls
+    if(s_writer->write(std::span<const u8>(reinterpret_cast<const u8*>(message.data()), message.size()))) {
+        s_writer->flush();
     }
-
-    file->write(message.c_str(), message.size(), size, 0);
 }
 
 void Logger::logProfiler() {
-    std::vector<Profiler::AveragedEntry> entries = Profiler::getAverages();
-    if(entries.empty()) {
+    std::vector<Profiler::AveragedEntry> entries       = Profiler::getAverages();
+    std::vector<Profiler::ThroughputEntry> throughputs = Profiler::getThroughputs();
+    if(entries.empty() && throughputs.empty()) {
         log("No Profiler Entries");
         return;
     }
@@ -169,6 +186,10 @@ void Logger::logProfiler() {
         maxSize = std::max(maxSize, entry.scopeName.size() + 1);
     }
 
+    for(const auto& entry : throughputs) {
+        maxSize = std::max(maxSize, entry.name.size() + 1);
+    }
+
     // if even make odd
     if((maxSize & 1) == 0) {
         maxSize++;
@@ -182,6 +203,15 @@ void Logger::logProfiler() {
         out += std::format("|{:<{}}|{:<{}}|\n", entry.scopeName, maxSize, (entry.average / 268) / 1000.0f, ticksWidth);
     }
 
+    if(!throughputs.empty()) {
+        out += std::format("|{:^{}}|{:^{}}|\n", "throughput", maxSize, "MB/s", ticksWidth);
+    }
+
+    // bytes per microsecond is MB/s
+    for(const auto& entry : throughputs) {
+        out += std::format("|{:<{}}|{:<{}}|\n", entry.name, maxSize, entry.bytes / (entry.ticks / 268.0f), ticksWidth);
+    }
+
     out += std::format("{:-^{}}\n", "", maxSize + ticksWidth + 3);
     log("{}", out);
 }
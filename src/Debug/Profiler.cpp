@@ -17,6 +17,7 @@ ProfilerScope::~ProfilerScope() {
 
 std::map<u64, Profiler::RunningEntry> Profiler::s_runningEntries   = {};
 std::map<std::string, Profiler::ProfilerEntry> Profiler::s_entries = {};
+std::map<std::string, Profiler::ThroughputEntry> Profiler::s_throughputs = {};
 
 Mutex Profiler::s_entriesMutex        = Mutex();
 Mutex Profiler::s_runningEntriesMutex = Mutex();
@@ -55,6 +56,7 @@ void Profiler::reset() {
 
     s_entries.clear();
     s_runningEntries.clear();
+    s_throughputs.clear();
 #endif
 }
 
@@ -97,6 +99,42 @@ std::vector<Profiler::AveragedEntry> Profiler::getAverages() {
 #endif
 }
 
+void Profiler::addThroughput(std::string name, u64 bytes, u64 ticks) {
+#ifdef DEBUG
+    auto lock = s_entriesMutex.lock();
+
+    ThroughputEntry& entry = s_throughputs[name];
+    entry.name             = name;
+    entry.bytes += bytes;
+    entry.ticks += ticks;
+#else
+    (void)name;
+    (void)bytes;
+    (void)ticks;
+#endif
+}
+
+std::vector<Profiler::ThroughputEntry> Profiler::getThroughputs() {
+#ifdef DEBUG
+    auto lock = s_entriesMutex.lock();
+
+    std::vector<ThroughputEntry> throughputs;
+    throughputs.reserve(s_throughputs.size());
+
+    for(const auto& entry : s_throughputs) {
+        if(entry.second.ticks == 0) {
+            continue;
+        }
+
+        throughputs.push_back(entry.second);
+    }
+
+    return throughputs;
+#else
+    return {};
+#endif
+}
+
 void Profiler::stop(u64 id) {
 #ifdef DEBUG
     const u64 stop = svcGetSystemTick();
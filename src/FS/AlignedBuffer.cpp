@@ -0,0 +1,33 @@
+#include <FS/AlignedBuffer.hpp>
+#include <malloc.h>
+#include <utility>
+
+AlignedBuffer::AlignedBuffer(size_t size, size_t alignment)
+    : m_data(size == 0 ? nullptr : reinterpret_cast<u8*>(memalign(alignment, size)))
+    , m_size(m_data == nullptr ? 0 : size) {}
+
+AlignedBuffer::~AlignedBuffer() { free(m_data); }
+
+AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0)) {}
+
+AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
+    if(this != &other) {
+        free(m_data);
+
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    return *this;
+}
+
+bool AlignedBuffer::valid() const { return m_data != nullptr; }
+
+u8* AlignedBuffer::data() { return m_data; }
+const u8* AlignedBuffer::data() const { return m_data; }
+size_t AlignedBuffer::size() const { return m_size; }
+
+std::span<u8> AlignedBuffer::span() { return { m_data, m_size }; }
+std::span<const u8> AlignedBuffer::span() const { return { m_data, m_size }; }
@@ -1,12 +1,20 @@
 #include <FS/Archive.hpp>
 #include <FS/Directory.hpp>
 #include <FS/File.hpp>
+#include <Util/Mutex.hpp>
 
 Result invalidResult() { return MAKERESULT(RL_REINITIALIZE, RS_INVALIDSTATE, RM_APPLICATION, RD_INVALID_HANDLE); }
 
+// titles are loaded from several threads, only one should open the archive
+static Mutex s_sdmcMutex;
 static std::shared_ptr<Archive> s_sdmc;
-void Archive::closeSDMC() { s_sdmc.reset(); }
+void Archive::closeSDMC() {
+    auto lock = s_sdmcMutex.lock();
+    s_sdmc.reset();
+}
+
 std::shared_ptr<Archive> Archive::sdmc() {
+    auto lock = s_sdmcMutex.lock();
     if(s_sdmc != nullptr) {
         return s_sdmc;
     }
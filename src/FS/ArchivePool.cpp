@@ -0,0 +1,98 @@
+#include <Debug/Profiler.hpp>
+#include <FS/ArchivePool.hpp>
+#include <algorithm>
+
+static Mutex s_poolMutex;
+static std::shared_ptr<ArchivePool> s_pool;
+void ArchivePool::close() {
+    auto lock = s_poolMutex.lock();
+    s_pool.reset();
+}
+
+std::shared_ptr<ArchivePool> ArchivePool::instance() {
+    auto lock = s_poolMutex.lock();
+    if(s_pool != nullptr) {
+        return s_pool;
+    }
+
+    struct make_shared_enabler : public ArchivePool {
+        make_shared_enabler()
+            : ArchivePool() {}
+    };
+    s_pool = std::make_shared<make_shared_enabler>();
+
+    return s_pool;
+}
+
+ArchivePool::ArchivePool()
+    : m_maxIdle(DEFAULT_MAX_IDLE) {}
+
+ArchivePool::~ArchivePool() {}
+
+std::shared_ptr<Archive> ArchivePool::acquire(u64 id, FS_MediaType mediaType, u8 container, const Opener& open) {
+    {
+        auto lock = m_mutex.lock();
+
+        auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& entry) { return entry.id == id && entry.mediaType == mediaType && entry.container == container; });
+        if(it != m_entries.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            return it->archive;
+        }
+    }
+
+    // opened without the lock, other titles shouldn't wait on it
+    std::shared_ptr<Archive> archive;
+    {
+        PROFILE_SCOPE("Open Archive");
+        archive = open();
+    }
+
+    if(archive == nullptr || !archive->valid()) {
+        return archive;
+    }
+
+    auto lock = m_mutex.lock();
+
+    // another thread may have opened the same one meanwhile, keep the pooled one so there's only ever one
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& entry) { return entry.id == id && entry.mediaType == mediaType && entry.container == container; });
+    if(it != m_entries.end()) {
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return it->archive;
+    }
+
+    m_entries.push_front(Entry{ id, mediaType, container, archive });
+    trim();
+
+    return archive;
+}
+
+void ArchivePool::invalidate(u64 id, FS_MediaType mediaType) {
+    auto lock = m_mutex.lock();
+    std::erase_if(m_entries, [&](const Entry& entry) { return entry.id == id && entry.mediaType == mediaType; });
+}
+
+void ArchivePool::invalidate(FS_MediaType mediaType) {
+    auto lock = m_mutex.lock();
+    std::erase_if(m_entries, [&](const Entry& entry) { return entry.mediaType == mediaType; });
+}
+
+size_t ArchivePool::maxIdle() const { return m_maxIdle; }
+void ArchivePool::setMaxIdle(size_t maxIdle) {
+    auto lock = m_mutex.lock();
+
+    m_maxIdle = maxIdle;
+    trim();
+}
+
+void ArchivePool::trim() {
+    size_t idle = 0;
+    for(auto it = m_entries.begin(); it != m_entries.end();) {
+        // in use elsewhere, closing it here would only drop the pool's reference
+        if(it->archive.use_count() > 1 || ++idle <= m_maxIdle) {
+            it++;
+            continue;
+        }
+
+        it = m_entries.erase(it);
+    }
+}
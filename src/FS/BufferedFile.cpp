@@ -0,0 +1,180 @@
+#include <FS/BufferedFile.hpp>
+#include <algorithm>
+#include <string.h>
+
+BufferedFileReader::BufferedFileReader(std::shared_ptr<File> file, u64 offset, u32 bufferSize)
+    : m_file(file)
+    , m_buffer(bufferSize)
+    , m_bufferOffset(offset)
+    , m_bufferFilled(0)
+    , m_position(0) {}
+
+bool BufferedFileReader::valid() const { return m_file != nullptr && m_file->valid() && m_buffer.valid(); }
+u64 BufferedFileReader::tell() const { return m_bufferOffset + m_position; }
+
+void BufferedFileReader::seek(u64 offset) {
+    if(offset >= m_bufferOffset && offset <= m_bufferOffset + m_bufferFilled) {
+        m_position = static_cast<u32>(offset - m_bufferOffset);
+        return;
+    }
+
+    m_bufferOffset = offset;
+    m_bufferFilled = 0;
+    m_position     = 0;
+}
+
+u64 BufferedFileReader::read(std::span<u8> data) {
+    if(!valid()) {
+        return U64_MAX;
+    }
+
+    u64 total = 0;
+    while(!data.empty()) {
+        if(m_position == m_bufferFilled) {
+            const u64 offset = tell();
+
+            // nothing buffered to keep, a read this large gains nothing from a copy
+            if(data.size() >= m_buffer.size()) {
+                u64 read = m_file->read(data, offset);
+                if(read == U64_MAX) {
+                    return U64_MAX;
+                }
+
+                m_bufferOffset = offset + read;
+                m_bufferFilled = 0;
+                m_position     = 0;
+
+                return total + read;
+            }
+
+            u64 read = m_file->read(m_buffer.span(), offset);
+            if(read == U64_MAX) {
+                return U64_MAX;
+            }
+
+            m_bufferOffset = offset;
+            m_bufferFilled = static_cast<u32>(read);
+            m_position     = 0;
+
+            if(read == 0) {
+                break;
+            }
+        }
+
+        const size_t size = std::min<size_t>(data.size(), m_bufferFilled - m_position);
+        memcpy(data.data(), m_buffer.data() + m_position, size);
+
+        m_position += size;
+        total += size;
+        data = data.subspan(size);
+    }
+
+    return total;
+}
+
+BufferedFileWriter::BufferedFileWriter(std::shared_ptr<File> file, u64 offset, u32 bufferSize, u32 flags)
+    : m_file(file)
+    , m_buffer(bufferSize)
+    , m_flags(flags)
+    , m_bufferOffset(offset)
+    , m_bufferFilled(0)
+    , m_failed(false) {}
+
+BufferedFileWriter::~BufferedFileWriter() { flush(); }
+
+bool BufferedFileWriter::open(std::shared_ptr<File> file, u64 offset) {
+    const bool flushed = m_file == nullptr || flush();
+
+    m_file         = file;
+    m_bufferOffset = offset;
+    m_bufferFilled = 0;
+    m_failed       = false;
+
+    return flushed;
+}
+
+void BufferedFileWriter::discard() {
+    m_file.reset();
+
+    m_bufferOffset = 0;
+    m_bufferFilled = 0;
+    m_failed       = false;
+}
+
+bool BufferedFileWriter::valid() const { return !m_failed && m_file != nullptr && m_file->valid() && m_buffer.valid(); }
+u64 BufferedFileWriter::tell() const { return m_bufferOffset + m_bufferFilled; }
+
+bool BufferedFileWriter::writeOut(std::span<const u8> data) {
+    while(!data.empty()) {
+        u32 wrote = m_file->write(data, m_bufferOffset, m_flags);
+        if(wrote == 0 || wrote == UINT32_MAX) {
+            m_failed = true;
+            return false;
+        }
+
+        m_bufferOffset += wrote;
+        data = data.subspan(wrote);
+    }
+
+    return true;
+}
+
+bool BufferedFileWriter::flush() {
+    if(!valid()) {
+        return false;
+    }
+    else if(m_bufferFilled == 0) {
+        return true;
+    }
+
+    const u32 filled = m_bufferFilled;
+    m_bufferFilled   = 0;
+
+    return writeOut(m_buffer.span().first(filled));
+}
+
+bool BufferedFileWriter::write(std::span<const u8> data) {
+    if(!valid()) {
+        return false;
+    }
+
+    while(!data.empty()) {
+        if(m_bufferFilled == m_buffer.size() && !flush()) {
+            return false;
+        }
+
+        // nothing buffered to keep in order, a write this large gains nothing from a copy
+        if(m_bufferFilled == 0 && data.size() >= m_buffer.size()) {
+            return writeOut(data);
+        }
+
+        const size_t size = std::min<size_t>(data.size(), m_buffer.size() - m_bufferFilled);
+        memcpy(m_buffer.data() + m_bufferFilled, data.data(), size);
+
+        m_bufferFilled += size;
+        data = data.subspan(size);
+    }
+
+    return true;
+}
+
+bool BufferedFileWriter::writeZeros(u64 count) {
+    if(!valid()) {
+        return false;
+    }
+
+    // zeroed in the buffer itself, never more than a buffer at a time
+    while(count != 0) {
+        if(m_bufferFilled == m_buffer.size() && !flush()) {
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(std::min<u64>(count, m_buffer.size() - m_bufferFilled));
+        memset(m_buffer.data() + m_bufferFilled, 0, size);
+
+        m_bufferFilled += size;
+        count -= size;
+    }
+
+    return true;
+}
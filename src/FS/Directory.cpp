@@ -1,6 +1,7 @@
 #include <FS/Archive.hpp>
 #include <FS/Directory.hpp>
 #include <FS/File.hpp>
+#include <algorithm>
 #include <vector>
 
 class DirectoryEntryPrivate {
@@ -136,4 +137,131 @@ void Directory::_reloadEntries() {
 
 std::vector<std::shared_ptr<DirectoryEntry>> Directory::entries() const { return m_entries; }
 std::vector<std::shared_ptr<DirectoryEntry>>::const_iterator Directory::begin() const { return m_entries.begin(); }
-std::vector<std::shared_ptr<DirectoryEntry>>::const_iterator Directory::end() const { return m_entries.end(); }
\ No newline at end of file
+std::vector<std::shared_ptr<DirectoryEntry>>::const_iterator Directory::end() const { return m_entries.end(); }
+
+DirectoryEntryView::DirectoryEntryView(const FS_DirectoryEntry* entry, const std::u16string* prefix) noexcept
+    : m_entry(entry)
+    , m_prefix(prefix) {}
+
+const std::u16string& DirectoryEntryView::prefix() const { return *m_prefix; }
+std::u16string_view DirectoryEntryView::name() const { return reinterpret_cast<const char16_t*>(m_entry->name); }
+std::u16string DirectoryEntryView::path() const {
+    std::u16string path = prefix();
+    path += name();
+
+    if(isDirectory()) {
+        path += u'/';
+    }
+
+    return path;
+}
+
+bool DirectoryEntryView::isDirectory() const { return (m_entry->attributes & FS_ATTRIBUTE_DIRECTORY) != 0; }
+bool DirectoryEntryView::isFile() const { return !isDirectory(); }
+
+bool DirectoryEntryView::isHidden() const { return (m_entry->attributes & FS_ATTRIBUTE_HIDDEN) != 0; }
+bool DirectoryEntryView::isReadOnly() const { return (m_entry->attributes & FS_ATTRIBUTE_READ_ONLY) != 0; }
+
+u64 DirectoryEntryView::fileSize() const { return m_entry->fileSize; }
+
+DirectoryReader::iterator::iterator(DirectoryReader* reader)
+    : m_reader(reader) {
+    // the current entry is always in the batch, read the first one
+    if(m_reader->m_batchPosition >= m_reader->m_batchFilled && !m_reader->readBatch()) {
+        m_reader = nullptr;
+    }
+}
+
+DirectoryEntryView DirectoryReader::iterator::operator*() const { return DirectoryEntryView(&m_reader->m_batch[m_reader->m_batchPosition], &m_reader->m_path); }
+DirectoryReader::iterator& DirectoryReader::iterator::operator++() {
+    if(++m_reader->m_batchPosition >= m_reader->m_batchFilled && !m_reader->readBatch()) {
+        m_reader = nullptr;
+    }
+
+    return *this;
+}
+
+bool DirectoryReader::iterator::operator==(const iterator& other) const { return m_reader == other.m_reader; }
+
+DirectoryReader::DirectoryReader(u32 batchSize)
+    : m_valid(false)
+    , m_lastResult(RL_SUCCESS)
+    , m_batch(std::max<u32>(batchSize, 1))
+    , m_batchFilled(0)
+    , m_batchPosition(0)
+    , m_lastBatch(true) {}
+
+DirectoryReader::DirectoryReader(std::shared_ptr<Archive> archive, std::u16string path, u32 batchSize)
+    : DirectoryReader(batchSize) {
+    open(archive, path);
+}
+
+DirectoryReader::~DirectoryReader() { close(); }
+
+bool DirectoryReader::open(std::shared_ptr<Archive> archive, std::u16string path) {
+    close();
+
+    m_path = std::move(path);
+    if(m_path.empty() || m_path.front() != u'/') {
+        m_path.insert(m_path.begin(), u'/');
+    }
+
+    if(m_path.back() != u'/') {
+        m_path += u'/';
+    }
+
+    if(archive == nullptr || !archive->valid()) {
+        m_lastResult = MAKERESULT(RL_PERMANENT, RS_INVALIDARG, RM_APPLICATION, RD_INVALID_HANDLE);
+        return false;
+    }
+
+    if(R_FAILED((m_lastResult = FSUSER_OpenDirectory(&m_handle, archive->handle(), fsMakePath(PATH_UTF16, m_path.c_str()))))) {
+        return false;
+    }
+
+    m_archive   = archive;
+    m_valid     = true;
+    m_lastBatch = false;
+
+    return true;
+}
+
+void DirectoryReader::close() {
+    if(m_valid) {
+        FSDIR_Close(m_handle);
+    }
+
+    m_valid = false;
+    m_archive.reset();
+
+    m_batchFilled   = 0;
+    m_batchPosition = 0;
+    m_lastBatch     = true;
+}
+
+bool DirectoryReader::valid() const { return m_valid; }
+const std::u16string& DirectoryReader::path() const { return m_path; }
+
+Result DirectoryReader::lastResult() const { return m_lastResult; }
+
+bool DirectoryReader::readBatch() {
+    m_batchFilled   = 0;
+    m_batchPosition = 0;
+
+    if(!m_valid || m_lastBatch) {
+        return false;
+    }
+
+    if(R_FAILED((m_lastResult = FSDIR_Read(m_handle, &m_batchFilled, m_batch.size(), m_batch.data())))) {
+        m_batchFilled = 0;
+        m_lastBatch   = true;
+
+        return false;
+    }
+
+    m_lastBatch = m_batchFilled < m_batch.size();
+    return m_batchFilled != 0;
+}
+
+DirectoryReader::iterator DirectoryReader::begin() { return iterator(this); }
+DirectoryReader::iterator DirectoryReader::end() { return iterator(); }
@@ -0,0 +1,98 @@
+#include <FS/DirectoryScanner.hpp>
+#include <vector>
+
+DirectoryScanner::DirectoryScanner(size_t helpers, Worker::Processor processor)
+    : m_helpers(std::make_unique<WorkerPool>([this](Worker*) { drain(false); }, 0, 0x4000, std::vector<Worker::Processor>(processor == Worker::SYSCORE ? 0 : helpers, processor)))
+    , m_reading(0)
+    , m_failed(false) {}
+
+DirectoryScanner::~DirectoryScanner() { m_helpers->waitForExit(); }
+
+bool DirectoryScanner::scan(std::shared_ptr<Archive> archive, std::u16string root, FileFunc func) {
+    if(archive == nullptr || !archive->valid()) {
+        return false;
+    }
+
+    {
+        auto lock = m_frontierChanged.mutex().lock();
+
+        m_frontier = { std::move(root) };
+        m_reading  = 0;
+        m_failed   = false;
+    }
+
+    m_archive = archive;
+    m_func    = std::move(func);
+
+    drain(true);
+    m_helpers->waitForExit();
+
+    m_archive.reset();
+    m_func = nullptr;
+
+    return !m_failed;
+}
+
+void DirectoryScanner::drain(bool startHelpers) {
+    // each thread reads with its own batch buffer, reused for every directory it takes
+    DirectoryReader reader;
+    std::vector<std::u16string> directories;
+
+    auto lock = m_frontierChanged.mutex().lock();
+    while(true) {
+        if(m_frontier.empty()) {
+            if(m_reading == 0) {
+                break;
+            }
+
+            // a wakeup can slip in between the check and the wait, the timeout covers it
+            lock.release();
+            m_frontierChanged.wait(1000000);
+            lock.lock();
+
+            continue;
+        }
+
+        std::u16string path = std::move(m_frontier.front());
+        m_frontier.pop_front();
+        m_reading++;
+
+        lock.release();
+
+        bool failed = !reader.open(m_archive, path);
+        for(const DirectoryEntryView& entry : reader) {
+            if(entry.isDirectory()) {
+                directories.push_back(entry.path());
+                continue;
+            }
+
+            auto funcLock = m_funcMutex.lock();
+            m_func(entry);
+        }
+
+        failed |= R_FAILED(reader.lastResult());
+        reader.close();
+
+        lock.lock();
+        m_reading--;
+        m_failed |= failed;
+
+        for(std::u16string& directory : directories) {
+            m_frontier.push_back(std::move(directory));
+        }
+
+        directories.clear();
+
+        const bool start = startHelpers && m_frontier.size() > 1;
+        lock.release();
+
+        // helpers waiting for more or for the last directory to finish
+        m_frontierChanged.broadcast();
+        if(start) {
+            startHelpers = false;
+            m_helpers->start();
+        }
+
+        lock.lock();
+    }
+}
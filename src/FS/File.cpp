@@ -66,11 +66,11 @@ Result File::lastResult() const { return m_lastResult; }
         return __VA_ARGS__;                                                                             \
     }
 
-u64 File::read(void* data, u32 max, u64 offset) {
+u64 File::read(std::span<u8> data, u64 offset) {
     CHECK_VALID(U64_MAX)
 
     u32 numRead = 0;
-    if(R_FAILED((m_lastResult = FSFILE_Read(m_handle, &numRead, offset, data, max)))) {
+    if(R_FAILED((m_lastResult = FSFILE_Read(m_handle, &numRead, offset, data.data(), data.size())))) {
         return U64_MAX;
     }
 
@@ -78,18 +78,18 @@ u64 File::read(void* data, u32 max, u64 offset) {
     return numRead;
 }
 
+u64 File::read(void* data, u32 max, u64 offset) { return read(std::span<u8>(reinterpret_cast<u8*>(data), max), offset); }
+
 bool File::read(std::vector<u8>& data, u32 max, u64 offset) {
     CHECK_VALID(false)
     data.resize(max);
 
-    u32 numRead = 0;
-    if(R_FAILED((m_lastResult = FSFILE_Read(m_handle, &numRead, offset, data.data(), max)))) {
+    u64 numRead = read(std::span<u8>(data), offset);
+    if(numRead == U64_MAX) {
         return false;
     }
 
     data.resize(numRead);
-
-    m_lastResult = RL_SUCCESS;
     return true;
 }
 
@@ -99,14 +99,12 @@ std::string File::readStr(u32 max, u64 offset) {
     std::string out;
     out.resize(max);
 
-    u32 numRead = 0;
-    if(R_FAILED((m_lastResult = FSFILE_Read(m_handle, &numRead, offset, out.data(), max)))) {
+    u64 numRead = read(std::span<u8>(reinterpret_cast<u8*>(out.data()), out.size()), offset);
+    if(numRead == U64_MAX) {
         return "";
     }
 
     out.resize(numRead);
-    m_lastResult = RL_SUCCESS;
-
     return out;
 }
 
@@ -121,44 +119,35 @@ std::vector<u8> File::read(u32 max, u64 offset) {
 std::string File::readLine(u64 offset) {
     CHECK_VALID("")
 
-    const u64 bufSize = 128;
-
-    u64 off = offset;
-    std::vector<u8> buf;
-
+    // on the stack so only the output string allocates
+    char buf[128];
     std::string out;
-    std::vector<u8>::iterator it = buf.end();
 
-    do {
-        buf = read(bufSize, off);
-        if(R_FAILED(m_lastResult)) {
+    while(true) {
+        u64 numRead = read(buf, sizeof(buf), offset);
+        if(numRead == U64_MAX) {
             return "";
         }
 
-        it = std::find(buf.begin(), buf.end(), '\n');
-        out += std::string(buf.begin(), it);
-    } while(buf.size() == bufSize && it == buf.end());
-
-    return out;
-}
+        char* end = buf + numRead;
+        char* it  = std::find(buf, end, '\n');
+        out.append(buf, static_cast<size_t>(it - buf));
 
-u32 File::write(const std::vector<u8>& data, u64 offset, u32 flags) {
-    CHECK_VALID(UINT32_MAX)
+        if(it != end || numRead < sizeof(buf)) {
+            break;
+        }
 
-    u32 numWritten = 0;
-    if(R_FAILED((m_lastResult = FSFILE_Write(m_handle, &numWritten, offset, data.data(), data.size(), flags)))) {
-        return UINT32_MAX;
+        offset += numRead;
     }
 
-    m_lastResult = RL_SUCCESS;
-    return numWritten;
+    return out;
 }
 
-u32 File::write(const void* data, u64 dataSize, u64 offset, u32 flags) {
+u32 File::write(std::span<const u8> data, u64 offset, u32 flags) {
     CHECK_VALID(UINT32_MAX)
 
     u32 numWritten = 0;
-    if(R_FAILED((m_lastResult = FSFILE_Write(m_handle, &numWritten, offset, data, dataSize, flags)))) {
+    if(R_FAILED((m_lastResult = FSFILE_Write(m_handle, &numWritten, offset, data.data(), data.size(), flags)))) {
         return UINT32_MAX;
     }
 
@@ -166,6 +155,9 @@ u32 File::write(const void* data, u64 dataSize, u64 offset, u32 flags) {
     return numWritten;
 }
 
+u32 File::write(const std::vector<u8>& data, u64 offset, u32 flags) { return write(std::span<const u8>(data), offset, flags); }
+u32 File::write(const void* data, u64 dataSize, u64 offset, u32 flags) { return write(std::span<const u8>(reinterpret_cast<const u8*>(data), dataSize), offset, flags); }
+
 bool File::flush() {
     CHECK_VALID(false)
 
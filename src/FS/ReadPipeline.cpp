@@ -0,0 +1,136 @@
+#include <FS/ReadPipeline.hpp>
+
+ReadPipeline::ReadPipeline(u32 bufferSize, Worker::Processor processor)
+    : m_bufferSize(bufferSize)
+    , m_cancel(false)
+    , m_reader(std::make_unique<Worker>([this](Worker* worker) { readerMain(worker); }, 1, 0x1000, processor)) {
+    LightSemaphore_Init(&m_job, 0, 1);
+
+    for(Slot& slot : m_slots) {
+        slot.buffer = AlignedBuffer(m_bufferSize);
+        slot.size   = 0;
+
+        LightSemaphore_Init(&slot.empty, 1, 1);
+        LightSemaphore_Init(&slot.full, 0, 1);
+    }
+
+    if(valid() && processor != Worker::SYSCORE) {
+        m_reader->start();
+    }
+}
+
+ReadPipeline::~ReadPipeline() {
+    m_reader->signalShouldExit();
+    LightSemaphore_Release(&m_job, 1);
+    m_reader->waitForExit();
+}
+
+bool ReadPipeline::valid() const { return m_bufferSize != 0 && m_slots[0].buffer.valid() && m_slots[1].buffer.valid(); }
+u32 ReadPipeline::bufferSize() const { return m_bufferSize; }
+
+u64 ReadPipeline::readDirect(std::shared_ptr<File> file, ChunkFunc& func) {
+    u64 offset               = 0;
+    const std::span<u8> data = m_slots[0].buffer.span();
+
+    while(true) {
+        u64 read = file->read(data, offset);
+        if(read == U64_MAX) {
+            return U64_MAX;
+        }
+        else if(read == 0) {
+            break;
+        }
+
+        offset += read;
+        if(!func(data.data(), read) || read < m_bufferSize) {
+            break;
+        }
+    }
+
+    return offset;
+}
+
+u64 ReadPipeline::read(std::shared_ptr<File> file, ChunkFunc func) {
+    if(!valid() || file == nullptr || !file->valid()) {
+        return U64_MAX;
+    }
+
+    u64 fileSize = file->size();
+    if(fileSize == U64_MAX) {
+        return U64_MAX;
+    }
+    else if(fileSize <= m_bufferSize || !m_reader->running()) {
+        return readDirect(file, func);
+    }
+
+    m_file   = file;
+    m_cancel = false;
+    LightSemaphore_Release(&m_job, 1);
+
+    bool failed = false;
+    u64 total   = 0;
+
+    u8 index = 0;
+    while(true) {
+        Slot& slot = m_slots[index];
+        LightSemaphore_Acquire(&slot.full, 1);
+
+        const u64 size = slot.size;
+        if(size == U64_MAX) {
+            failed = true;
+        }
+        else if(size != 0 && !m_cancel) {
+            total += size;
+
+            if(!func(slot.buffer.data(), size)) {
+                m_cancel = true;
+            }
+        }
+
+        LightSemaphore_Release(&slot.empty, 1);
+
+        // the reader stops after a short or failed chunk, everything before it has been drained
+        if(size != m_bufferSize) {
+            break;
+        }
+
+        index ^= 1;
+    }
+
+    m_file.reset();
+    return failed ? U64_MAX : total;
+}
+
+void ReadPipeline::readerMain(Worker* worker) {
+    while(true) {
+        LightSemaphore_Acquire(&m_job, 1);
+        if(worker->waitingForExit()) {
+            return;
+        }
+
+        u64 offset = 0;
+        u8 index   = 0;
+
+        while(true) {
+            Slot& slot = m_slots[index];
+            LightSemaphore_Acquire(&slot.empty, 1);
+
+            if(m_cancel || worker->waitingForExit()) {
+                slot.size = 0;
+            }
+            else {
+                slot.size = m_file->read(slot.buffer.span(), offset);
+            }
+
+            const u64 size = slot.size;
+            LightSemaphore_Release(&slot.full, 1);
+
+            if(size != m_bufferSize) {
+                break;
+            }
+
+            offset += size;
+            index ^= 1;
+        }
+    }
+}
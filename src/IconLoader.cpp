@@ -0,0 +1,205 @@
+#include <Debug/Logger.hpp>
+#include <IconLoader.hpp>
+#include <algorithm>
+
+IconLoader::IconLoader(size_t budget)
+    : m_budget(budget)
+    , m_loading(nullptr)
+    , m_working(false)
+    , m_worker(std::make_unique<Worker>([this](Worker*) { workerMain(); }, 1, 0x4000, Worker::APPCORE)) {}
+
+IconLoader::~IconLoader() {
+    {
+        auto lock = m_mutex.lock();
+        m_pending.clear();
+    }
+
+    m_worker->waitForExit();
+}
+
+size_t IconLoader::budget() const { return m_budget; }
+void IconLoader::setBudget(size_t budget) { m_budget = budget; }
+
+bool IconLoader::contains(const TitleSet& set, const std::shared_ptr<Title>& title) {
+    auto it = set.find(title.get());
+    return it != set.end() && it->second.lock() == title;
+}
+
+bool IconLoader::queued(const Title* title) const {
+    if(title == m_loading) {
+        return true;
+    }
+
+    return std::any_of(m_finished.begin(), m_finished.end(), [title](const auto& entry) { return entry.first.get() == title; });
+}
+
+void IconLoader::setLoaded(const std::shared_ptr<Title>& title, std::shared_ptr<IconAtlas::Slot> slot) {
+    title->setIcon(std::move(slot));
+
+    auto it = m_loadedIndex.find(title.get());
+    if(it != m_loadedIndex.end()) {
+        m_loaded.splice(m_loaded.begin(), m_loaded, it->second);
+        return;
+    }
+
+    m_loaded.push_front(title);
+    m_loadedIndex[title.get()] = m_loaded.begin();
+}
+
+size_t IconLoader::evict(size_t maxLoaded) {
+    size_t evicted = 0;
+    for(; m_loaded.size() > maxLoaded; evicted++) {
+        std::shared_ptr<Title> title = m_loaded.back();
+        title->setIcon(nullptr);
+
+        m_loadedIndex.erase(title.get());
+        m_loaded.pop_back();
+    }
+
+    return evicted;
+}
+
+size_t IconLoader::evictInvalid() {
+    const auto expired = [](const auto& entry) {
+        std::shared_ptr<Title> title = entry.second.lock();
+        return title == nullptr || !title->valid();
+    };
+    std::erase_if(m_failed, expired);
+    std::erase_if(m_noSlot, expired);
+
+    size_t evicted = 0;
+    for(auto it = m_loaded.begin(); it != m_loaded.end();) {
+        if((*it)->valid()) {
+            it++;
+            continue;
+        }
+
+        (*it)->setIcon(nullptr);
+
+        m_loadedIndex.erase(it->get());
+        it = m_loaded.erase(it);
+
+        evicted++;
+    }
+
+    return evicted;
+}
+
+void IconLoader::request(const std::vector<std::shared_ptr<Title>>& titles) {
+    std::vector<std::pair<std::shared_ptr<Title>, std::vector<u16>>> finished;
+    {
+        auto lock = m_mutex.lock();
+        finished.swap(m_finished);
+    }
+
+    size_t evicted = evictInvalid();
+
+    // in reverse so the first requested ends up most recent
+    size_t requestedLoaded = 0;
+    for(auto it = titles.rbegin(); it != titles.rend(); it++) {
+        auto loaded = m_loadedIndex.find(it->get());
+        if(loaded != m_loadedIndex.end()) {
+            m_loaded.splice(m_loaded.begin(), m_loaded, loaded->second);
+            requestedLoaded++;
+        }
+    }
+
+    // make room before setting the finished icons so they take the slots just freed instead of a new page
+    const size_t maxLoaded = std::max(titles.size(), m_budget / ICON_SIZE);
+    const size_t incoming  = static_cast<size_t>(std::count_if(finished.begin(), finished.end(), [](const auto& entry) { return !entry.second.empty(); }));
+    evicted += evict(std::max(requestedLoaded, maxLoaded > incoming ? maxLoaded - incoming : 0));
+
+    // a freed slot can take an icon that didn't fit before
+    const bool retry = evicted > 0 && !m_noSlot.empty();
+    if(evicted > 0) {
+        m_noSlot.clear();
+    }
+
+    for(auto& [title, iconData] : finished) {
+        if(!title->valid()) {
+            continue;
+        }
+
+        if(iconData.empty()) {
+            m_failed[title.get()] = title;
+            continue;
+        }
+
+        std::shared_ptr<IconAtlas::Slot> slot = m_atlas.add(iconData.data());
+        if(slot != nullptr) {
+            setLoaded(title, std::move(slot));
+        }
+        else {
+            m_noSlot[title.get()] = title;
+        }
+    }
+
+    m_atlas.trim();
+
+    std::vector<const Title*> request;
+    request.reserve(titles.size());
+    for(const std::shared_ptr<Title>& title : titles) {
+        request.push_back(title.get());
+    }
+
+    // the view usually hasn't moved since the last frame
+    if(request == m_lastRequest && finished.empty() && !retry) {
+        return;
+    }
+
+    m_lastRequest = std::move(request);
+
+    bool start = false;
+    {
+        auto lock = m_mutex.lock();
+
+        m_pending.clear();
+        for(const std::shared_ptr<Title>& title : titles) {
+            if(title != nullptr && title->valid() && !title->hasIcon() && !queued(title.get()) && !contains(m_failed, title) && !contains(m_noSlot, title)) {
+                m_pending.push_back(title);
+            }
+        }
+
+        if(!m_pending.empty() && !m_working) {
+            m_working = true;
+            start     = true;
+        }
+    }
+
+    if(start) {
+        // the last run has already returned or is about to
+        m_worker->waitForExit();
+        m_worker->start();
+    }
+}
+
+void IconLoader::workerMain() {
+    while(!m_worker->waitingForExit()) {
+        std::shared_ptr<Title> title;
+
+        {
+            auto lock = m_mutex.lock();
+            if(m_pending.empty()) {
+                m_working = false;
+                return;
+            }
+
+            title = m_pending.front();
+            m_pending.pop_front();
+
+            m_loading = title.get();
+        }
+
+        std::vector<u16> iconData = title->loadIcon();
+        if(iconData.empty()) {
+            Logger::warn("Icon Loader", "Failed to load icon for {:X}", title->id());
+        }
+
+        auto lock = m_mutex.lock();
+        m_finished.push_back({ title, std::move(iconData) });
+        m_loading = nullptr;
+    }
+
+    auto lock = m_mutex.lock();
+    m_working = false;
+}
@@ -1,15 +1,18 @@
+#include <Cache.hpp>
 #include <Debug/Logger.hpp>
 #include <Debug/Profiler.hpp>
-#include <FS/Directory.hpp>
+#include <FS/ArchivePool.hpp>
+#include <FS/DirectoryScanner.hpp>
 #include <FS/File.hpp>
+#include <FS/ReadPipeline.hpp>
 #include <Title.hpp>
+#include <TitleCache.hpp>
+#include <Util/PlayHistory.hpp>
 #include <Util/StringUtil.hpp>
 #include <Util/Worker.hpp>
-#include <iomanip>
 #include <iostream>
-#include <list>
-#include <md5.h>
-#include <sstream>
+#include <xxh64.h>
+#include <zlib.h>
 
 std::string getContainerName(Container container) {
     switch(container) {
@@ -34,13 +37,18 @@ constexpr std::shared_ptr<Archive> _extdata(u32 id) {
     return Archive::open(ARCHIVE_EXTDATA, FS_Path{ PATH_BINARY, sizeof(path), path });
 }
 
-Title::Title(u64 id, FS_MediaType mediaType, FS_CardType cardType)
+Title::Title(u64 id, FS_MediaType mediaType, FS_CardType cardType, u64 accessStamp)
     : m_valid(false)
     , m_saveAccessible(false)
     , m_extdataAccessible(false)
+    , m_accessKnown(false)
+    , m_accessStamp(accessStamp)
+    , m_accessCheckedAt(0)
     , m_id(id)
     , m_mediaType(mediaType)
     , m_cardType(cardType)
+    , m_saveHashedAt(0)
+    , m_extdataHashedAt(0)
     , m_outOfDate(0) {
     PROFILE_SCOPE("Load Title");
 
@@ -48,18 +56,34 @@ Title::Title(u64 id, FS_MediaType mediaType, FS_CardType cardType)
         strcpy(m_productCode, "Invalid");
     }
 
-    {
-        PROFILE_SCOPE("Load Title Accessibles");
-
-        auto archive     = _save(m_mediaType, lowID(), highID());
-        m_saveAccessible = archive != nullptr && archive->valid();
-
-        archive             = _extdata(extdataID());
-        m_extdataAccessible = archive != nullptr && archive->valid();
+    // the cache decides if the containers have to be probed, invalid if neither is accessible
+    m_valid = true;
+    if(!loadCache()) {
+        m_valid = false;
+        return;
+    }
+}
 
-        if(!m_saveAccessible && !m_extdataAccessible) {
-            return;
-        }
+Title::Title(const TitleSnapshot::Entry& entry)
+    : m_valid(false)
+    , m_saveAccessible(entry.accessible & SAVE)
+    , m_extdataAccessible(entry.accessible & EXTDATA)
+    , m_accessKnown(true)
+    , m_accessStamp(0)
+    , m_accessCheckedAt(0)
+    , m_id(entry.id)
+    , m_mediaType(static_cast<FS_MediaType>(entry.mediaType))
+    , m_cardType(CARD_CTR)
+    , m_saveHashedAt(0)
+    , m_extdataHashedAt(0)
+    , m_outOfDate(entry.outOfDate) {
+    PROFILE_SCOPE("Load Title From Snapshot");
+
+    memcpy(m_productCode, entry.productCode, sizeof(m_productCode));
+    m_productCode[sizeof(m_productCode) - 1] = '\0';
+
+    if(!m_saveAccessible && !m_extdataAccessible) {
+        return;
     }
 
     m_valid = true;
@@ -71,11 +95,14 @@ Title::Title(u64 id, FS_MediaType mediaType, FS_CardType cardType)
 
 Title::~Title() {
     m_icon = { nullptr, nullptr };
-    m_tex.reset();
+    m_iconSlot.reset();
 }
 
 bool Title::valid() const { return m_valid; }
-void Title::setInvalid() { m_valid = false; }
+void Title::setInvalid() {
+    m_valid = false;
+    ArchivePool::instance()->invalidate(m_id, m_mediaType);
+}
 
 FS_MediaType Title::mediaType() const { return m_mediaType; }
 FS_CardType Title::cardType() const { return m_cardType; }
@@ -90,6 +117,35 @@ const char* Title::productCode() const { return m_productCode; }
 std::string Title::shortDescription() const { return m_shortDescription; }
 std::string Title::longDescription() const { return m_longDescription; }
 C2D_Image* Title::icon() { return &m_icon; }
+bool Title::hasIcon() const { return m_icon.tex != nullptr; }
+
+void Title::setIcon(std::shared_ptr<IconAtlas::Slot> slot) {
+    auto lock = m_iconMutex.lock();
+
+    m_iconSlot = slot;
+    m_icon     = m_iconSlot != nullptr ? m_iconSlot->image() : C2D_Image{ nullptr, nullptr };
+}
+
+std::vector<u16> Title::loadIcon() {
+    if(!m_valid) return {};
+    PROFILE_SCOPE("Load Title Icon");
+
+    std::vector<u16> iconData(SMDH::ICON_WIDTH * SMDH::ICON_HEIGHT);
+
+    std::unique_ptr<TitleCache::TitleData> titleData = std::make_unique<TitleCache::TitleData>();
+    if(m_mediaType == MEDIATYPE_SD && readCachedTitleData(*titleData)) {
+        memcpy(iconData.data(), titleData->iconData, iconData.size() * sizeof(u16));
+        return iconData;
+    }
+
+    std::unique_ptr<SMDH> smdh = std::make_unique<SMDH>(m_id, m_mediaType);
+    if(!smdh->valid()) {
+        return {};
+    }
+
+    memcpy(iconData.data(), smdh->bigIconData(), iconData.size() * sizeof(u16));
+    return iconData;
+}
 
 // from checkpoint
 u32 Title::extdataID() const {
@@ -116,24 +172,34 @@ u32 Title::extdataID() const {
     }
 }
 
-std::shared_ptr<Archive> Title::openContainer(Container container) const {
+std::shared_ptr<Archive> Title::openContainer(Container container) {
     if(!m_valid) return nullptr;
 
+    std::shared_ptr<Archive> archive;
     switch(container) {
     case SAVE:
         if(!m_saveAccessible) {
             return nullptr;
         }
 
-        return _save(m_mediaType, lowID(), highID());
+        archive = ArchivePool::instance()->acquire(m_id, m_mediaType, SAVE, [this]() { return _save(m_mediaType, lowID(), highID()); });
+        break;
     case EXTDATA:
         if(!m_extdataAccessible) {
             return nullptr;
         }
 
-        return _extdata(extdataID());
+        archive = ArchivePool::instance()->acquire(m_id, m_mediaType, EXTDATA, [this]() { return _extdata(extdataID()); });
+        break;
     default: return nullptr;
     }
+
+    // the cached accessibility may be stale, the next save of the cache makes the next start probe again
+    if(archive == nullptr || !archive->valid()) {
+        m_accessStamp = 0;
+    }
+
+    return archive;
 }
 
 Mutex& Title::containerMutex(Container container) {
@@ -153,6 +219,42 @@ bool Title::containerAccessible(Container container) const {
     }
 }
 
+u64 Title::accessStamp(const AM_TitleEntry& info) { return (static_cast<u64>(info.version) << 48) ^ info.size; }
+u32 Title::accessCheckedAt() const { return m_accessCheckedAt; }
+
+void Title::probeContainers() {
+    PROFILE_SCOPE("Load Title Accessibles");
+
+    // a pooled archive only shows the container was accessible when it was opened
+    std::shared_ptr<ArchivePool> pool = ArchivePool::instance();
+    pool->invalidate(m_id, m_mediaType);
+
+    // pooled so the load right after doesn't open them again
+    auto archive     = pool->acquire(m_id, m_mediaType, SAVE, [this]() { return _save(m_mediaType, lowID(), highID()); });
+    m_saveAccessible = archive != nullptr && archive->valid();
+
+    archive             = pool->acquire(m_id, m_mediaType, EXTDATA, [this]() { return _extdata(extdataID()); });
+    m_extdataAccessible = archive != nullptr && archive->valid();
+
+    m_accessCheckedAt = PlayHistory::currentMinutes();
+}
+
+bool Title::probeAccessibility() {
+    if(!m_valid) return false;
+
+    const bool save    = m_saveAccessible;
+    const bool extdata = m_extdataAccessible;
+    probeContainers();
+
+    if(m_saveAccessible && !save) loadContainerFiles(SAVE, false);
+    if(m_extdataAccessible && !extdata) loadContainerFiles(EXTDATA, false);
+
+    // keeps the new check time even if nothing changed
+    saveCache();
+
+    return m_saveAccessible != save || m_extdataAccessible != extdata;
+}
+
 Result Title::deleteSecureSaveValue() {
     if(!m_valid) return MAKERESULT(RL_PERMANENT, RS_INVALIDSTATE, RM_APPLICATION, RD_INVALID_SELECTION);
 
@@ -216,6 +318,39 @@ void Title::setContainerFiles(std::vector<FileInfo>& files, Container container)
     saveCache();
 }
 
+std::vector<FileInfo> Title::scanFiles(std::shared_ptr<Archive> archive, const std::vector<FileInfo>& files, std::u16string root) {
+    // by path id, interning a scanned path finds the id any earlier copy of it has
+    std::unordered_map<u32, const FileInfo*> oldFiles;
+    for(const auto& file : files) {
+        oldFiles.emplace(file.path.id(), &file);
+    }
+
+    std::vector<FileInfo> newFiles;
+    newFiles.reserve(files.size());
+
+    // sizes come from the listing, new files don't have to be opened
+    DirectoryScanner scanner;
+    scanner.scan(archive, root, [&oldFiles, &newFiles](const DirectoryEntryView& entry) {
+        const InternedPath path = InternedPath::fromUTF16(entry.path());
+
+        auto it = oldFiles.find(path.id());
+        if(it != oldFiles.end()) {
+            newFiles.push_back(*it->second);
+            return;
+        }
+
+        newFiles.push_back(FileInfo{
+            .path = path,
+            .size = entry.fileSize(),
+
+            ._shouldUpdateHash = true,
+        });
+    });
+
+    std::sort(newFiles.begin(), newFiles.end());
+    return newFiles;
+}
+
 void Title::loadContainerFiles(Container container, bool cache, std::shared_ptr<Archive> archive, bool shouldLock) {
     if(!m_valid) return;
 
@@ -234,62 +369,9 @@ void Title::loadContainerFiles(Container container, bool cache, std::shared_ptr<
     }
 
     PROFILE_SCOPE("Load Title Container");
-    std::vector<FileInfo>& files = containerFiles(container);
-    std::unordered_map<std::u16string, FileInfo> oldFiles;
-
-    for(const auto& file : files) {
-        oldFiles.emplace(file.nativePath, file);
-    }
-
-    std::vector<FileInfo> newFiles;
-    std::list<std::shared_ptr<Directory>> directories = { archive->openDirectory() };
-    while(directories.size() >= 1) {
-        std::shared_ptr<Directory> dir = directories.front();
-        if(dir == nullptr || !dir->valid()) {
-            goto skip;
-        }
-
-        for(auto entry : *dir) {
-            if(entry->isDirectory()) {
-                directories.push_back(entry->openDirectory());
-                continue;
-            }
-            else if(!entry->isFile()) {
-                continue;
-            }
-
-            auto it = oldFiles.find(entry->path());
-            if(it != oldFiles.end()) {
-                newFiles.push_back(it->second);
-
-                continue;
-            }
-
-            std::shared_ptr<File> file = entry->openFile(FS_OPEN_READ, 0);
-            if(file == nullptr || !file->valid()) {
-                continue;
-            }
+    std::vector<FileInfo>& files   = containerFiles(container);
+    std::vector<FileInfo> newFiles = scanFiles(archive, files);
 
-            u64 size = file->size();
-            if(size == U64_MAX) {
-                continue;
-            }
-
-            newFiles.push_back(FileInfo{
-                .nativePath = entry->path(),
-                .path       = StringUtil::toUTF8(entry->path()),
-
-                .size = size,
-
-                ._shouldUpdateHash = true,
-            });
-        }
-
-    skip:
-        directories.pop_front();
-    }
-
-    std::sort(newFiles.begin(), newFiles.end());
     files.swap(newFiles);
 
     if(cache) {
@@ -301,70 +383,139 @@ void Title::loadContainerFiles(Container container, bool cache, std::shared_ptr<
     }
 }
 
-void Title::hashContainer(Container container) {
+void Title::markContainerChanged(Container container) {
     if(!m_valid) return;
 
     auto lock = containerMutex(container).lock();
-
-    std::shared_ptr<Archive> archive = openContainer(container);
-    loadContainerFiles(container, false, archive, false);
-
-    std::vector<FileInfo>& files = containerFiles(container);
-    if(archive == nullptr || !archive->valid()) {
-        return;
+    for(FileInfo& info : containerFiles(container)) {
+        info._shouldUpdateHash = true;
     }
+}
 
-    PROFILE_SCOPE("Hash Container");
+u32 Title::lastHashed(Container container) const {
+    if(!m_valid) return 0;
+    return container == SAVE ? m_saveHashedAt : m_extdataHashedAt;
+}
+
+u64 Title::hashFiles(std::shared_ptr<Archive> archive, std::vector<FileInfo>& files, ReadPipeline& pipeline, HashAlgorithm hashAlgorithm) {
+    u64 totalRead = 0;
 
     u64 newSize;
     for(auto it = files.begin(); it != files.end();) {
         FileInfo& info = *it;
 
-        std::shared_ptr<File> file = archive->openFile(info.nativePath, FS_OPEN_READ, 0);
+        std::shared_ptr<File> file = archive->openFile(info.path.utf16(), FS_OPEN_READ, 0);
         if(file == nullptr || !file->valid() || (newSize = file->size()) == U64_MAX) {
             it = files.erase(it);
             continue;
         }
 
-        info.size = file->size();
+        info.size = newSize;
+
+        std::unique_ptr<Hasher> hasher = Hasher::create(hashAlgorithm);
+        const bool resumable           = hasher->resumable();
+
+        // blocks with a matching checksum reuse the stored state until the first changed block
+        // only worth it for slow algorithms, the checksum costs about as much as a fast hash
+        // xxh64 isn't collision resistant, a changed block keeps its old digest if its checksum happens to match (about 2^-64 per block)
+        // nothing guards against a block crafted to collide, saves aren't treated as adversarial
+        std::vector<BlockDigest> oldBlocks = info.hash.has_value() && info.hashAlgorithm == hashAlgorithm ? std::move(info.blocks) : std::vector<BlockDigest>();
+        info.blocks.clear();
+        if(resumable) {
+            info.blocks.reserve(newSize / HASH_BLOCK_SIZE);
+        }
+
+        bool diverged = false;
+        u64 read      = pipeline.read(file, [&](const u8* data, u32 size) {
+            if(!resumable) {
+                hasher->update(data, size);
+                return true;
+            }
+
+            // chunks are a multiple of the block size, only the last one can end in a partial block
+            for(; size >= HASH_BLOCK_SIZE; data += HASH_BLOCK_SIZE, size -= HASH_BLOCK_SIZE) {
+                u64 checksum;
+                xxh64(data, HASH_BLOCK_SIZE, 0, reinterpret_cast<u8*>(&checksum));
 
-        MD5Context ctx;
-        md5Init(&ctx);
+                const size_t index = info.blocks.size();
 
-        u64 offset = 0;
-        std::vector<u8> buf;
+                if(!diverged && index < oldBlocks.size() && oldBlocks[index].checksum == checksum) {
+                    hasher->restoreState(oldBlocks[index].state, static_cast<u64>(index + 1) * HASH_BLOCK_SIZE);
+                }
+                else {
+                    diverged = true;
+                    hasher->update(data, HASH_BLOCK_SIZE);
+                }
 
-        do {
-            buf = file->read(0x1000, offset);
-            offset += buf.size();
+                BlockDigest block = { .checksum = checksum };
+                hasher->saveState(block.state);
+                info.blocks.push_back(block);
+            }
 
-            md5Update(&ctx, buf.data(), buf.size());
-        } while(buf.size() >= 1);
+            hasher->update(data, size);
+            return true;
+        });
 
-        md5Finalize(&ctx);
+        if(read == U64_MAX) {
+            Logger::warn("Hash Container", "Failed to read {}", info.path.utf8());
+            it = files.erase(it);
 
-        char hash[33];
-        for(u8 i = 0; i < 16; i++) {
-            snprintf(&hash[i * 2], 3, "%02x", ctx.digest[i]);
+            continue;
         }
 
+        totalRead += read;
+
         info._shouldUpdateHash = false;
-        info.hash              = hash;
+        info.hash              = hasher->finalize();
+        info.hashAlgorithm     = hashAlgorithm;
 
         it++;
     }
 
-    lock.release();
-    saveCache();
+    return totalRead;
 }
 
-constexpr std::string formatFileInfo(Container container, FileInfo file) {
-    return std::format("{}{}{}:{}\n", container == SAVE ? 's' : 'e', file.size, file.path, file.hash.value_or(""));
-}
+void Title::hashContainer(Container container, ReadPipeline* pipeline, bool skipUnchanged) {
+    if(!m_valid) return;
+
+    auto lock = containerMutex(container).lock();
+    if(skipUnchanged) {
+        const std::vector<FileInfo>& files = containerFiles(container);
+        if(!files.empty() && std::all_of(files.begin(), files.end(), [](const FileInfo& info) { return info.hash.has_value() && info.hashAlgorithm == Hasher::preferred() && !info._shouldUpdateHash; })) {
+            return;
+        }
+    }
+
+    const u32 hashedAt                = PlayHistory::currentMinutes();
+    const HashAlgorithm hashAlgorithm = Hasher::preferred();
+
+    std::shared_ptr<Archive> archive = openContainer(container);
+    loadContainerFiles(container, false, archive, false);
 
-constexpr size_t versionSize = 3;
+    std::vector<FileInfo>& files = containerFiles(container);
+    if(archive == nullptr || !archive->valid()) {
+        return;
+    }
+
+    PROFILE_SCOPE("Hash Container");
+
+    std::unique_ptr<ReadPipeline> ownedPipeline;
+    if(pipeline == nullptr || !pipeline->valid()) {
+        ownedPipeline = std::make_unique<ReadPipeline>(HASH_READ_SIZE);
+        pipeline      = ownedPipeline.get();
+    }
 
-bool Title::loadSMDHData() {
+    const u64 startTick = svcGetSystemTick();
+    const u64 totalRead = hashFiles(archive, files, *pipeline, hashAlgorithm);
+
+    Profiler::addThroughput(std::format("Hash {} ({})", getContainerName(container), Hasher::name(hashAlgorithm)), totalRead, svcGetSystemTick() - startTick);
+    (container == SAVE ? m_saveHashedAt : m_extdataHashedAt) = hashedAt;
+
+    lock.release();
+    saveCache();
+}
+
+bool Title::loadSMDHData(TitleCache::TitleData* titleData) {
     if(!m_valid) return false;
 
     std::unique_ptr<SMDH> smdh = std::make_unique<SMDH>(m_id, m_mediaType);
@@ -379,76 +530,102 @@ bool Title::loadSMDHData() {
     m_longDescription = StringUtil::toUTF8(smdh->applicationTitle(1).longDescription);
     std::replace(m_longDescription.begin(), m_longDescription.end(), '\n', ' ');
 
-    m_tex  = smdh->bigTex();
-    m_icon = { m_tex->handle(), &SMDH::ICON_SUBTEX };
+    if(titleData != nullptr) {
+        memcpy(titleData->iconData, smdh->bigIconData(), sizeof(titleData->iconData));
+    }
 
     return true;
 }
 
-void Title::saveCache() {
-    if(!m_valid || m_mediaType != MEDIATYPE_SD) return;
+bool Title::readCachedTitleData(TitleCache::TitleData& titleData) {
+    std::shared_ptr<Cache> cache = Cache::instance();
+    std::vector<u8> data;
+
+    return cache != nullptr && cache->valid() && cache->read(m_id, data) && TitleCache::decodeTitleData(data, titleData);
+}
+
+bool Title::saveCache() {
+    if(!m_valid || m_mediaType != MEDIATYPE_SD) return true;
     PROFILE_SCOPE("Save Title Cache");
 
-    auto lock                     = m_cacheMutex.lock();
-    std::shared_ptr<Archive> sdmc = Archive::sdmc();
-    if(sdmc == nullptr || !sdmc->valid()) {
-        Logger::error("Save Title Cache", "Failed to open sdmc");
-        return;
+    auto lock                    = m_cacheMutex.lock();
+    std::shared_ptr<Cache> cache = Cache::instance();
+    if(cache == nullptr || !cache->valid()) {
+        Logger::error("Save Title Cache", "Cache unavailable");
+        return false;
     }
 
-    if(!sdmc->mkdir(u"/3ds/" EXE_NAME, 0, true)) {
-        Logger::error("Save Title Cache", "Failed to create data directory");
-        return;
-    }
+    std::unique_ptr<TitleCache::TitleData> titleData = std::make_unique<TitleCache::TitleData>();
+    memset(titleData.get(), 0, sizeof(TitleCache::TitleData));
 
-    std::string path = std::format("/3ds/" EXE_NAME "/{:X}", m_id);
-    sdmc->deleteFile(path);
+    std::shared_ptr<IconAtlas::Slot> slot;
+    {
+        auto iconLock = m_iconMutex.lock();
+        slot          = m_iconSlot;
+    }
 
-    if((m_icon.tex == nullptr || m_tex == nullptr) && !loadSMDHData()) {
+    // the icon is usually unloaded, the last record still has it without asking the services
+    // descriptions are only empty when there's no usable record, both then come from the smdh
+    const bool hasDescriptions = !m_shortDescription.empty() || !m_longDescription.empty();
+    if(slot != nullptr && hasDescriptions) {
+        slot->read(titleData->iconData);
+    }
+    else if(!(hasDescriptions && readCachedTitleData(*titleData)) && !loadSMDHData(titleData.get())) {
         Logger::error("Save Title Cache", "Failed to load SMDH data");
-        return;
+        return false;
     }
 
-    std::ostringstream stream;
-    // version
-    stream << std::setfill('0') << std::setw(versionSize) << "1";
-    stream << std::left << std::setfill('\0') << std::setw(sizeof(SMDH::ApplicationTitle::shortDescription) / sizeof(u16)) << m_shortDescription;
-    stream << std::left << std::setfill('\0') << std::setw(sizeof(SMDH::ApplicationTitle::longDescription) / sizeof(u16)) << m_longDescription;
+    strncpy(titleData->shortDescription, m_shortDescription.c_str(), sizeof(titleData->shortDescription));
+    strncpy(titleData->longDescription, m_longDescription.c_str(), sizeof(titleData->longDescription));
+
+    std::vector<u8> data;
+    {
+        auto saveLock    = m_saveMutex.lock();
+        auto extdataLock = m_extdataMutex.lock();
 
-    // copy image data directly to stream
-    const u16* src = reinterpret_cast<u16*>(m_icon.tex->data) + (SMDH::ICON_DATA_WIDTH - SMDH::ICON_WIDTH) * SMDH::ICON_DATA_HEIGHT;
-    for(u16 j = 0; j < SMDH::ICON_HEIGHT; j += 8) {
-        stream.write(reinterpret_cast<const char*>(src), SMDH::ICON_WIDTH * 8 * sizeof(u16));
-        src += SMDH::ICON_DATA_WIDTH * 8;
+        const TitleCache::Access access = {
+            .stamp      = m_accessStamp,
+            .checkedAt  = m_accessCheckedAt,
+            .accessible = static_cast<u8>((m_saveAccessible ? SAVE : 0) | (m_extdataAccessible ? EXTDATA : 0))
+        };
+
+        data = TitleCache::encode(*titleData, m_saveFiles, m_extdataFiles, m_saveHashedAt, m_extdataHashedAt, access);
     }
 
-    for(auto container : { SAVE, EXTDATA }) {
-        auto containerLock = containerMutex(container).lock();
+    if(!cache->write(m_id, data)) {
+        Logger::warn("Save Title Cache", "Failed to write cache data");
+    }
 
-        for(auto file : getContainerFiles(container)) {
-            stream << formatFileInfo(container, file);
-        }
+    return true;
+}
+
+static std::string legacyCachePath(u64 id) { return std::format("/3ds/" EXE_NAME "/{:X}", id); }
+
+// reads the per title cache file used before the shared cache, it's only removed once migrated
+static bool readLegacyCacheFile(u64 id, std::vector<u8>& data) {
+    std::shared_ptr<Archive> sdmc = Archive::sdmc();
+    if(sdmc == nullptr || !sdmc->valid()) {
+        return false;
     }
 
-    PROFILE_SCOPE("Save Cache File");
-    auto file = sdmc->openFile(path, FS_OPEN_WRITE | FS_OPEN_CREATE, 0);
+    std::shared_ptr<File> file = sdmc->openFile(legacyCachePath(id), FS_OPEN_READ, 0);
     if(file == nullptr || !file->valid()) {
-        Logger::warn("Save Title Cache", "Failed to open cache file");
-        return;
+        return false;
     }
 
-    const std::string& str = stream.str();
-    if(!file->setSize(str.size())) {
-        Logger::warn("Save Title Cache", "Failed to set cache file size");
-        Logger::warn("Save Title Cache", file->lastResult());
-
-        return;
+    const u64 size = file->size();
+    if(size == U64_MAX || size > UINT32_MAX) {
+        return false;
     }
 
-    u32 wrote = file->write(str.c_str(), str.size(), 0, FS_WRITE_FLUSH);
-    if(wrote == 0 || wrote == UINT32_MAX) {
-        Logger::warn("Save Title Cache", "Failed to write cache data");
-        Logger::warn("Save Title Cache", file->lastResult());
+    data.resize(size);
+    return file->read(data.data(), static_cast<u32>(size), 0) == size;
+}
+
+static void removeLegacyCacheFile(u64 id) {
+    std::shared_ptr<Archive> sdmc = Archive::sdmc();
+    if(sdmc != nullptr && sdmc->valid()) {
+        sdmc->deleteFile(legacyCachePath(id));
     }
 }
 
@@ -457,235 +634,134 @@ bool Title::loadCache() {
 
     // TODO: should use cached smdh, cant rely on cached container files as it could be a different cart
     if(m_mediaType != MEDIATYPE_SD) {
+        probeContainers();
+        if(!m_saveAccessible && !m_extdataAccessible) {
+            return false;
+        }
+
         if(m_saveAccessible) loadContainerFiles(SAVE);
         if(m_extdataAccessible) loadContainerFiles(EXTDATA);
 
         return loadSMDHData();
     }
 
-    struct TitleData {
-        char shortDesc[sizeof(SMDH::ApplicationTitle::shortDescription) / sizeof(u16)], longDesc[sizeof(SMDH::ApplicationTitle::longDescription) / sizeof(u16)];
-        u16 texData[SMDH::ICON_WIDTH * SMDH::ICON_HEIGHT];
-    };
-
     PROFILE_SCOPE("Load Title Cache");
 
     auto lock        = m_cacheMutex.lock();
     auto saveLock    = m_saveMutex.lock();
     auto extdataLock = m_extdataMutex.lock();
 
-    std::shared_ptr<Archive> sdmc = Archive::sdmc();
-    std::shared_ptr<File> file;
+    std::shared_ptr<Cache> cache = Cache::instance();
 
-    if(sdmc == nullptr || !sdmc->valid()) {
-        goto invalidSDMC;
+    std::vector<u8> data;
+    TitleCache::Contents contents;
+    bool migrate = false;
+
+    if(cache == nullptr || !cache->valid()) {
+        goto invalidCacheStore;
     }
 
-    file = sdmc->openFile(std::format("/3ds/" EXE_NAME "/{:X}", m_id), FS_OPEN_READ, 0);
-    if(file == nullptr || !file->valid()) {
-        Logger::info("Load Cached Title Files", "Cache doesn't exist for {:X}, creating", m_id);
+    if(!cache->read(m_id, data)) {
+        if(!readLegacyCacheFile(m_id, data)) {
+            Logger::info("Load Cached Title Files", "Cache doesn't exist for {:X}, creating", m_id);
 
-        if(false) {
-        invalidSDMC:
-            Logger::info("Load Title Cached Files", "Failed to open sdmc");
-            if(sdmc != nullptr) {
-                Logger::info("Load Title Cached Files", sdmc->lastResult());
+            if(false) {
+            invalidCacheStore:
+                Logger::info("Load Title Cached Files", "Cache unavailable");
             }
-        }
 
-        if(false) {
-        invalidCache:
-            Logger::info("Load Title Cached Files", "Cache doesn't have required entries for {:X}, updating", m_id);
-        }
+            if(false) {
+            invalidCache:
+                Logger::info("Load Title Cached Files", "Cache doesn't have required entries for {:X}, updating", m_id);
+            }
 
-    invalid:
-        m_saveFiles.clear();
-        m_extdataFiles.clear();
+            m_saveFiles.clear();
+            m_extdataFiles.clear();
 
-        m_icon = { nullptr, nullptr };
-        m_tex.reset();
+            // descriptions are empty, the record has to come from the smdh
+            m_shortDescription.clear();
+            m_longDescription.clear();
 
-        file.reset();
-        lock.release();
+            lock.release();
 
-        if(m_saveAccessible) loadContainerFiles(SAVE, false, nullptr, false);
-        if(m_extdataAccessible) loadContainerFiles(EXTDATA, false, nullptr, false);
+            if(!m_accessKnown) {
+                probeContainers();
+            }
 
-        saveLock.release();
-        extdataLock.release();
+            if(!m_saveAccessible && !m_extdataAccessible) {
+                return false;
+            }
 
-        saveCache();
-        return m_icon.tex != nullptr;
-    }
+            if(m_saveAccessible) loadContainerFiles(SAVE, false, nullptr, false);
+            if(m_extdataAccessible) loadContainerFiles(EXTDATA, false, nullptr, false);
 
-    const u64 fileSize = file->size();
-    if(R_FAILED(file->lastResult()) || fileSize == U64_MAX) {
-        goto invalidCache;
-    }
+            saveLock.release();
+            extdataLock.release();
 
-    char version[versionSize];
+            const bool saved = saveCache();
 
-    u64 read = file->read(version, versionSize, 0);
-    if(read != versionSize || R_FAILED(file->lastResult())) {
-        goto invalidCache;
-    }
+            // an old file that couldn't be decoded is replaced by the rebuilt record
+            if(migrate && cache->read(m_id, data)) {
+                removeLegacyCacheFile(m_id);
+            }
 
-    if(strncmp(version, "001", versionSize) != 0) {
-        goto invalidCache;
-    }
+            return saved;
+        }
 
-    u64 fileOffset = read;
-    if(fileSize - fileOffset < sizeof(TitleData)) {
-        goto invalidCache;
+        Logger::info("Load Title Cached Files", "Migrating cache file for {:X}", m_id);
+        migrate = true;
     }
 
-    std::unique_ptr<TitleData> titleData;
-    titleData.reset(new TitleData);
-    read = file->read(titleData.get(), sizeof(TitleData), fileOffset);
-
-    if(read != sizeof(TitleData) || R_FAILED(file->lastResult())) {
+    // text caches only exist as old per title files
+    if(TitleCache::isBinary(data) ? !TitleCache::decode(data, contents) : !migrate || !TitleCache::decodeLegacy(data, contents)) {
         goto invalidCache;
     }
 
-    fileOffset += read;
-    m_shortDescription = titleData->shortDesc;
-    m_longDescription  = titleData->longDesc;
-
-    m_tex  = TexWrapper::create(SMDH::ICON_DATA_WIDTH, SMDH::ICON_DATA_HEIGHT, GPU_RGB565);
-    m_icon = { m_tex->handle(), &SMDH::ICON_SUBTEX };
-
-    SMDH::copyImageData(titleData->texData, SMDH::ICON_WIDTH, SMDH::ICON_HEIGHT, reinterpret_cast<u16*>(m_icon.tex->data), SMDH::ICON_DATA_WIDTH, SMDH::ICON_DATA_HEIGHT);
-
-    m_saveFiles.clear();
-    m_extdataFiles.clear();
-
-    constexpr u64 maxBuf = 0x100;
-    u64 bufSize          = 0;
-    char buf[maxBuf];
-
-    enum ReadingType {
-        CONTAINER_CODE = 0,
-        SIZE,
-        PATH,
-        HASH
-    };
-
-    ReadingType reading = CONTAINER_CODE;
-    u64 offset          = bufSize;
-
-    char container = '\0';
-    u64 size       = 0;
-
-    constexpr u32 pathMax = 0x100;
-    u32 pathSize          = 0;
-    char path[pathMax];
-
-    constexpr u32 hashMax = 32;
-    u32 hashSize          = 0;
-    char hash[hashMax];
-
-    while(true) {
-        if(offset >= bufSize) {
-            offset = 0;
-
-            bufSize = file->read(buf, maxBuf, fileOffset);
-            if(bufSize == U64_MAX || R_FAILED(file->lastResult())) {
-                Logger::error("Load Title Cached Files", "Failed to read cache file");
-                goto invalid;
-            }
-            else if(bufSize <= 0) {
-                break;
-            }
-
-            fileOffset += bufSize;
-        }
-
-        switch(reading) {
-        case CONTAINER_CODE:
-            container = buf[offset];
-            offset++;
-
-            reading = SIZE;
-            break;
-        case SIZE:
-            for(; offset < bufSize; offset++) {
-                if(!isdigit(static_cast<int>(buf[offset]))) {
-                    reading = PATH;
-                    break;
-                }
-
-                size *= 10;
-                size += static_cast<u64>(buf[offset] - '0');
-            }
-
-            break;
-        case PATH:
-            for(; offset < bufSize; offset++) {
-                char c = buf[offset];
-                if(c == ':') {
-                    reading = HASH;
-                    offset++;
-
-                    break;
-                }
-                else if(pathSize + 1 >= pathMax) {
-                    goto invalidCache;
-                }
-
-                path[pathSize++] = c;
-            }
+    m_shortDescription = std::string(contents.titleData->shortDescription, strnlen(contents.titleData->shortDescription, sizeof(contents.titleData->shortDescription)));
+    m_longDescription  = std::string(contents.titleData->longDescription, strnlen(contents.titleData->longDescription, sizeof(contents.titleData->longDescription)));
 
-            break;
-        case HASH:
-            for(; offset < bufSize; offset++) {
-                char c = buf[offset];
-                if(c == '\n' || c == '\0') {
-                    goto addEntry;
-                }
-                else if(hashSize + 1 > hashMax) {
-                    goto invalidCache;
-                }
+    m_saveFiles    = std::move(contents.saveFiles);
+    m_extdataFiles = std::move(contents.extdataFiles);
 
-                hash[hashSize++] = c;
-            }
+    m_saveHashedAt    = contents.saveHashedAt;
+    m_extdataHashedAt = contents.extdataHashedAt;
 
-            break;
-        default: goto invalidCache;
-        }
-
-        continue;
-    addEntry:
-        if(hashSize != 0 && hashSize != hashMax) {
-            goto invalidCache;
-        }
+    bool probed = false;
+    if(m_accessKnown) {
+        // from the snapshot, the record's stamp is kept so a full load can still skip probing
+        m_accessStamp     = contents.access.stamp;
+        m_accessCheckedAt = contents.access.checkedAt;
+    }
+    else if(m_accessStamp != 0 && contents.access.stamp == m_accessStamp) {
+        m_saveAccessible    = contents.access.accessible & SAVE;
+        m_extdataAccessible = contents.access.accessible & EXTDATA;
+        m_accessCheckedAt   = contents.access.checkedAt;
+    }
+    else {
+        probeContainers();
+        probed = true;
+    }
 
-        reading = CONTAINER_CODE;
+    if(!m_saveAccessible && !m_extdataAccessible) {
+        return false;
+    }
 
-        std::optional<std::string> hashStr;
-        if(hashSize != 0) {
-            hashStr = std::string(hash, hashSize);
-        }
+    if(migrate || probed) {
+        lock.release();
 
-        std::string pathStr = std::string(path, pathSize);
+        // a container the record didn't have has no files yet
+        if(m_saveAccessible && m_saveFiles.empty()) loadContainerFiles(SAVE, false, nullptr, false);
+        if(m_extdataAccessible && m_extdataFiles.empty()) loadContainerFiles(EXTDATA, false, nullptr, false);
 
-        FileInfo info = {
-            .nativePath = StringUtil::fromUTF8(pathStr),
-            .path       = pathStr,
-            .hash       = hashStr,
-            .size       = size
-        };
+        saveLock.release();
+        extdataLock.release();
 
-        switch(container) {
-        case 's': m_saveFiles.push_back(info); break;
-        case 'e': m_extdataFiles.push_back(info); break;
-        default:  goto invalidCache;
-        }
+        saveCache();
+    }
 
-        container = '\0';
-        size      = 0;
-        pathSize  = 0;
-        hashSize  = 0;
-        offset++;
+    // the old file is the only copy until the migrated record can be read back
+    if(migrate && cache->read(m_id, data)) {
+        removeLegacyCacheFile(m_id);
     }
 
     return true;
@@ -0,0 +1,298 @@
+#include <TitleCache.hpp>
+#include <Util/StringUtil.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <string.h>
+#include <zlib.h>
+
+namespace TitleCache {
+
+static bool isHex(const char* str, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if(!isxdigit(static_cast<int>(str[i]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static u8 parseHex8(const char* str) {
+    auto nibble = [](char c) { return static_cast<u8>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10); };
+    return static_cast<u8>((nibble(str[0]) << 4) | nibble(str[1]));
+}
+
+static std::vector<FileInfo>* containerFiles(Contents& out, char container) {
+    switch(container) {
+    case 's': return &out.saveFiles;
+    case 'e': return &out.extdataFiles;
+    default:  return nullptr;
+    }
+}
+
+bool isBinary(const std::vector<u8>& data) {
+    return data.size() >= sizeof(MAGIC) && memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+std::vector<u8> encode(const TitleData& titleData, const std::vector<FileInfo>& saveFiles, const std::vector<FileInfo>& extdataFiles, u32 saveHashedAt, u32 extdataHashedAt, const Access& access) {
+    std::vector<FileRecord> records;
+    records.reserve(saveFiles.size() + extdataFiles.size());
+
+    std::vector<BlockDigest> blocks;
+    std::string strings;
+
+    for(auto [container, files] : { std::make_pair('s', &saveFiles), std::make_pair('e', &extdataFiles) }) {
+        for(const FileInfo& file : *files) {
+            FileRecord record = {};
+            record.size       = file.size;
+            record.pathOffset = static_cast<u32>(strings.size());
+            record.pathSize   = static_cast<u32>(file.path.utf8().size());
+            record.container  = static_cast<u8>(container);
+
+            // hashes that don't match their algorithm's size (e.g. malformed from the server) are dropped and recalculated later
+            const u8 digestSize = Hasher::digestSize(file.hashAlgorithm);
+            if(file.hash.has_value() && digestSize != 0 && file.hash->size() == digestSize * 2u && isHex(file.hash->data(), file.hash->size())) {
+                record.hasHash       = 1;
+                record.hashAlgorithm = file.hashAlgorithm;
+                for(u8 i = 0; i < digestSize; i++) {
+                    record.hash[i] = parseHex8(file.hash->data() + i * 2);
+                }
+
+                record.blockStart = static_cast<u32>(blocks.size());
+                record.blockCount = static_cast<u32>(file.blocks.size());
+                blocks.insert(blocks.end(), file.blocks.begin(), file.blocks.end());
+            }
+
+            strings += file.path.utf8();
+            records.push_back(record);
+        }
+    }
+
+    Header header          = {};
+    header.version         = VERSION;
+    header.headerSize      = sizeof(Header);
+    header.fileCount       = static_cast<u32>(records.size());
+    header.blockCount      = static_cast<u32>(blocks.size());
+    header.stringsSize     = static_cast<u32>(strings.size());
+    header.titleDataOffset = sizeof(Header);
+    header.filesOffset     = header.titleDataOffset + sizeof(TitleData);
+    header.blocksOffset    = header.filesOffset + header.fileCount * sizeof(FileRecord);
+    header.stringsOffset   = header.blocksOffset + header.blockCount * sizeof(BlockDigest);
+    header.saveHashedAt    = saveHashedAt;
+    header.extdataHashedAt = extdataHashedAt;
+    header.accessStamp     = access.stamp;
+    header.accessCheckedAt = access.checkedAt;
+    header.accessible      = access.accessible;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+
+    std::vector<u8> out(header.stringsOffset + header.stringsSize);
+    memcpy(out.data() + header.titleDataOffset, &titleData, sizeof(TitleData));
+    memcpy(out.data() + header.filesOffset, records.data(), records.size() * sizeof(FileRecord));
+    memcpy(out.data() + header.blocksOffset, blocks.data(), blocks.size() * sizeof(BlockDigest));
+    memcpy(out.data() + header.stringsOffset, strings.data(), strings.size());
+
+    header.checksum = crc32(0, out.data() + sizeof(Header), static_cast<uInt>(out.size() - sizeof(Header)));
+    memcpy(out.data(), &header, sizeof(Header));
+
+    return out;
+}
+
+// header size of each readable version, fields a version doesn't have are left zeroed
+static size_t headerSize(u16 version) {
+    switch(version) {
+    case 3:  return offsetof(Header, saveHashedAt);
+    case 4:
+    case 5:  return offsetof(Header, accessStamp);
+    case 6:
+    case 7:  return sizeof(Header);
+    default: return 0;
+    }
+}
+
+static size_t blockDigestSize(u16 version) { return version < 7 ? LEGACY_BLOCK_DIGEST_SIZE : sizeof(BlockDigest); }
+
+// reads and validates the header, bounds and checksum
+static bool readHeader(const std::vector<u8>& data, Header& header) {
+    header = {};
+    if(!isBinary(data) || data.size() < offsetof(Header, checksum)) {
+        return false;
+    }
+
+    memcpy(&header, data.data(), offsetof(Header, checksum));
+
+    const size_t size = headerSize(header.version);
+    if(size == 0 || header.headerSize != size || data.size() < size) {
+        return false;
+    }
+
+    memcpy(&header, data.data(), size);
+
+    // offsets are checked as u64 so corrupt counts can't overflow past the bounds check
+    const u64 dataSize = data.size();
+    if(static_cast<u64>(header.titleDataOffset) + sizeof(TitleData) > dataSize ||
+       static_cast<u64>(header.filesOffset) + static_cast<u64>(header.fileCount) * sizeof(FileRecord) > dataSize ||
+       static_cast<u64>(header.blocksOffset) + static_cast<u64>(header.blockCount) * blockDigestSize(header.version) > dataSize ||
+       static_cast<u64>(header.stringsOffset) + header.stringsSize > dataSize) {
+        return false;
+    }
+
+    return crc32(0, data.data() + header.headerSize, static_cast<uInt>(data.size() - header.headerSize)) == header.checksum;
+}
+
+bool decodeTitleData(const std::vector<u8>& data, TitleData& out) {
+    Header header;
+    if(!readHeader(data, header)) {
+        return false;
+    }
+
+    memcpy(&out, data.data() + header.titleDataOffset, sizeof(TitleData));
+    return true;
+}
+
+bool decode(const std::vector<u8>& data, Contents& out) {
+    Header header;
+    if(!readHeader(data, header)) {
+        return false;
+    }
+
+    out.titleData = std::make_unique<TitleData>();
+    memcpy(out.titleData.get(), data.data() + header.titleDataOffset, sizeof(TitleData));
+    out.saveFiles.clear();
+    out.extdataFiles.clear();
+    out.saveHashedAt    = header.saveHashedAt;
+    out.extdataHashedAt = header.extdataHashedAt;
+    out.access          = { .stamp = header.accessStamp, .checkedAt = header.accessCheckedAt, .accessible = header.accessible };
+
+    const char* strings = reinterpret_cast<const char*>(data.data() + header.stringsOffset);
+    for(u32 i = 0; i < header.fileCount; i++) {
+        FileRecord record;
+        memcpy(&record, data.data() + header.filesOffset + i * sizeof(FileRecord), sizeof(FileRecord));
+
+        if(static_cast<u64>(record.pathOffset) + record.pathSize > header.stringsSize ||
+           static_cast<u64>(record.blockStart) + record.blockCount > header.blockCount) {
+            return false;
+        }
+
+        std::vector<FileInfo>* files = containerFiles(out, static_cast<char>(record.container));
+        if(files == nullptr) {
+            return false;
+        }
+
+        FileInfo info = {
+            .path = InternedPath(std::string_view(strings + record.pathOffset, record.pathSize)),
+            .size = record.size
+        };
+
+        // the algorithm byte was reserved and zeroed (md5) before version 5
+        const u8 digestSize = Hasher::digestSize(record.hashAlgorithm);
+        if(record.hasHash && digestSize != 0) {
+            std::string hash;
+            hash.reserve(digestSize * 2);
+
+            for(u8 j = 0; j < digestSize; j++) {
+                hash += std::format("{:02x}", record.hash[j]);
+            }
+
+            info.hash          = std::move(hash);
+            info.hashAlgorithm = record.hashAlgorithm;
+
+            // older digests can't be compared with new checksums, the first rehash hashes the whole file
+            if(header.version >= 7) {
+                info.blocks.resize(record.blockCount);
+                memcpy(info.blocks.data(), data.data() + header.blocksOffset + record.blockStart * sizeof(BlockDigest), record.blockCount * sizeof(BlockDigest));
+            }
+        }
+
+        files->push_back(std::move(info));
+    }
+
+    return true;
+}
+
+bool decodeLegacy(const std::vector<u8>& data, Contents& out) {
+    constexpr size_t versionSize = 3;
+    if(data.size() < versionSize + sizeof(TitleData)) {
+        return false;
+    }
+
+    // 001 has no block digests
+    const char* str = reinterpret_cast<const char*>(data.data());
+    if(strncmp(str, "001", versionSize) != 0 && strncmp(str, "002", versionSize) != 0) {
+        return false;
+    }
+
+    out.titleData = std::make_unique<TitleData>();
+    memcpy(out.titleData.get(), data.data() + versionSize, sizeof(TitleData));
+    out.saveFiles.clear();
+    out.extdataFiles.clear();
+
+    constexpr size_t hashSize  = 32;
+    // blocks are parsed to validate the entry but dropped, their crc32 checksums can't be compared with xxh64
+    constexpr size_t blockSize = LEGACY_BLOCK_DIGEST_SIZE * 2;
+
+    // each line is <container><size><path>:<hash>[;<blocks>], entries end at a newline or null
+    const char* end = str + data.size();
+    const char* it  = str + versionSize + sizeof(TitleData);
+    while(it < end) {
+        const char* lineEnd = it;
+        while(lineEnd < end && *lineEnd != '\n' && *lineEnd != '\0') {
+            lineEnd++;
+        }
+
+        // unterminated trailing entries were never read by the old loader either
+        if(lineEnd == end) {
+            break;
+        }
+
+        std::vector<FileInfo>* files = containerFiles(out, *it++);
+        if(files == nullptr) {
+            return false;
+        }
+
+        u64 size = 0;
+        for(; it < lineEnd && isdigit(static_cast<int>(*it)); it++) {
+            size *= 10;
+            size += static_cast<u64>(*it - '0');
+        }
+
+        const char* pathEnd = std::find(it, lineEnd, ':');
+        if(pathEnd == lineEnd) {
+            return false;
+        }
+
+        const std::string_view path(it, static_cast<size_t>(pathEnd - it));
+        it = pathEnd + 1;
+
+        const char* hashEnd     = std::find(it, lineEnd, ';');
+        const size_t hashLength = static_cast<size_t>(hashEnd - it);
+        if(hashLength != 0 && hashLength != hashSize) {
+            return false;
+        }
+
+        FileInfo info = {
+            .path = InternedPath(path),
+            .size = size
+        };
+
+        if(hashLength != 0) {
+            info.hash = std::string(it, hashLength);
+        }
+
+        if(hashEnd != lineEnd) {
+            it = hashEnd + 1;
+
+            const size_t blocksLength = static_cast<size_t>(lineEnd - it);
+            if(hashLength == 0 || blocksLength % blockSize != 0 || !isHex(it, blocksLength)) {
+                return false;
+            }
+        }
+
+        files->push_back(std::move(info));
+        it = lineEnd + 1;
+    }
+
+    return true;
+}
+
+}; // namespace TitleCache
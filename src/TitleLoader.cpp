@@ -1,17 +1,86 @@
+#include <Cache.hpp>
 #include <Debug/Logger.hpp>
 #include <Debug/Profiler.hpp>
+#include <FS/ArchivePool.hpp>
 #include <TitleLoader.hpp>
+#include <Util/PlayHistory.hpp>
 #include <Util/StringUtil.hpp>
+#include <algorithm>
 #include <map>
+#include <string.h>
+#include <unordered_set>
+
+// libctru only allows one of our threads on SYSCORE, the card watcher keeps it while it runs there
+// it mostly sleeps waiting on card events, so it stays on APPCORE and leaves SYSCORE to hashing
+constexpr Worker::Processor cardWorkerProcessor = Worker::APPCORE;
+// otherwise a hash helper takes it
+constexpr bool hashOnSysCore = cardWorkerProcessor != Worker::SYSCORE;
+
+// cpu time for our SYSCORE thread, raised while a hash helper is running there and lowered back after
+constexpr u32 defaultAppCpuTimeLimit = 5;
+constexpr u32 hashingAppCpuTimeLimit = 30;
+
+// card events cover inserts and removals, polling only catches anything they miss
+constexpr s64 cardFallbackPollMS = 5000;
+// without events the card is polled like before
+constexpr s64 cardPollMS = 100;
+// polls at cardPollMS after an insert event for up to 3 seconds
+constexpr u32 cardSettleChecks = 30;
+
+// threads constructing titles alongside the load worker
+constexpr size_t titleLoadHelpers = 3;
+
+// a failed count or list is logged and returns false
+static bool sdTitleIDs(u32 numTitles, std::vector<u64>& ids) {
+    Result res;
+    if(numTitles == UINT32_MAX && R_FAILED(res = AM_GetTitleCount(MEDIATYPE_SD, &numTitles))) {
+        Logger::warn("Load SD Titles", "Failed to get title count");
+        Logger::warn("Load SD Titles", res);
+        return false;
+    }
+
+    ids.resize(numTitles);
+    if(numTitles == 0) {
+        return true;
+    }
+
+    if(R_FAILED(res = AM_GetTitleList(&numTitles, MEDIATYPE_SD, numTitles, ids.data()))) {
+        Logger::warn("Load SD Titles", "Failed to get SDCard title list");
+        Logger::warn("Load SD Titles", res);
+        return false;
+    }
+
+    ids.resize(numTitles);
+    return true;
+}
 
-TitleLoader::TitleLoader()
-    : m_lastCardID(0)
-    , m_cardWorker(std::make_unique<Worker>([this](Worker*) { cardWorkerMain(); }, 2, 0x1000, Worker::SYSCORE))
+static std::vector<Worker::Processor> hashPoolProcessors() {
+    // the hash worker itself runs on APPCORE
+    std::vector<Worker::Processor> processors = Worker::availableProcessors();
+    std::erase_if(processors, [](Worker::Processor processor) noexcept { return processor == Worker::APPCORE || (processor == Worker::SYSCORE && !hashOnSysCore); });
+
+    return processors;
+}
+
+TitleLoader::TitleLoader(std::unique_ptr<CardEventSource> cardEvents, TitleOrderFactory orderFactory)
+    : m_publishedTitles(std::make_shared<const TitleList>())
+    , m_titlesComplete(false)
+    , m_skippedCheckedAt(0)
+    , m_orderFactory(orderFactory)
+    , m_order(nullptr)
+    , m_history(nullptr)
+    , m_lastCardID(0)
+    , m_cardEvents(std::move(cardEvents))
+    , m_cardWorker(std::make_unique<Worker>([this](Worker*) { cardWorkerMain(); }, 2, 0x1000, cardWorkerProcessor))
     , m_loaderWorker(std::make_unique<Worker>([this](Worker*) { loadWorkerMain(); }, 4, 0x10000, Worker::APPCORE))
+    , m_loadPool(std::make_unique<WorkerPool>([this](Worker*) { loadQueueMain(); }, 4, 0x10000, std::vector<Worker::Processor>(titleLoadHelpers, Worker::APPCORE)))
+    , m_nextLoad(0)
+    , m_nextPublish(0)
     , m_hashWorker(std::make_unique<Worker>([this](Worker*) { hashWorkerMain(); }, 3, 0x3000, Worker::APPCORE))
+    , m_hashPool(std::make_unique<WorkerPool>([this](Worker*) { hashQueueMain(); }, 3, 0x3000, hashPoolProcessors()))
     , p_AM(Services::AM()) {
     // needed for SYSCORE thread
-    APT_SetAppCpuTimeLimit(5);
+    APT_SetAppCpuTimeLimit(defaultAppCpuTimeLimit);
     reloadTitles();
 }
 
@@ -22,23 +91,37 @@ TitleLoader::~TitleLoader() {
     titleHashedSignal.clear();
 
     m_cardWorker->signalShouldExit();
-    m_condVar.broadcast();
+    m_cardEvents->wake();
 
     m_loaderWorker->waitForExit();
     m_loaderWorker.reset();
+    m_loadPool.reset();
 
-    m_hashWorker->waitForExit();
-    m_hashWorker.reset();
+    // keeps the latest out of date state for the next start
+    if(m_titlesComplete) {
+        saveSnapshot();
+    }
 
+    // the card worker can restart hashing, it's stopped first
     m_cardWorker->waitForExit();
+
+    auto lock = m_hashRestartMutex.lock();
+    m_hashWorker->waitForExit();
+    m_hashWorker.reset();
+    m_hashPool.reset();
 }
 
 void TitleLoader::reloadTitles() {
     m_loaderWorker->waitForExit();
+
+    // an incremental reload keeps the current titles, so the list stays usable
+    m_loadingTitles = !m_titlesComplete;
     m_loaderWorker->start();
 }
 
 void TitleLoader::reloadHashes() {
+    auto lock = m_hashRestartMutex.lock();
+
     m_hashWorker->waitForExit();
     m_hashWorker->start();
 }
@@ -46,7 +129,7 @@ void TitleLoader::reloadHashes() {
 size_t TitleLoader::totalTitles() const { return m_totalTitles; }
 size_t TitleLoader::titlesLoaded() const { return m_titlesLoaded; }
 
-bool TitleLoader::isLoadingTitles() const { return m_loaderWorker->running(); }
+bool TitleLoader::isLoadingTitles() const { return m_loadingTitles; }
 
 bool TitleLoader::loadGameCardTitle() {
     auto cleanupLastCard = [this]() {
@@ -54,33 +137,25 @@ bool TitleLoader::loadGameCardTitle() {
             return;
         }
 
-        auto lock = m_titlesMutex.lock();
-        for(auto it = m_titles.begin(); it != m_titles.end();) {
-            if(*it == nullptr) {
-                it = m_titles.erase(it);
-
-                m_totalTitles--;
-                titlesLoadedChangedSignal(--m_titlesLoaded);
-
-                continue;
-            }
+        {
+            auto lock = m_titlesMutex.lock();
 
-            std::shared_ptr<Title> title = *it;
-            if(title->id() == m_lastCardID && title->mediaType() == MEDIATYPE_GAME_CARD) {
+            auto it = m_titleIndex.find({ m_lastCardID, MEDIATYPE_GAME_CARD });
+            if(it != m_titleIndex.end()) {
+                std::shared_ptr<Title> title = it->second;
                 title->setInvalid();
-                title = nullptr;
 
-                it = m_titles.erase(it);
+                std::erase(m_titles, title);
+                m_titleIndex.erase(it);
+                publishTitles();
 
                 m_totalTitles--;
                 titlesLoadedChangedSignal(--m_titlesLoaded);
-
-                break;
             }
-
-            it++;
         }
 
+        // anything opened from the card is gone with it, even if its title never finished loading
+        ArchivePool::instance()->invalidate(MEDIATYPE_GAME_CARD);
         m_lastCardID = 0;
     };
 
@@ -113,14 +188,11 @@ bool TitleLoader::loadGameCardTitle() {
     {
         auto lock = m_titlesMutex.lock();
         m_titles.insert(m_titles.begin(), title);
+        m_titleIndex[{ id, MEDIATYPE_GAME_CARD }] = title;
+        publishTitles();
     }
 
-    static bool first = true;
-    if(!first) {
-        m_totalTitles++;
-    }
-
-    first = false;
+    m_totalTitles++;
     titlesLoadedChangedSignal(++m_titlesLoaded);
 
     return true;
@@ -129,38 +201,303 @@ bool TitleLoader::loadGameCardTitle() {
 void TitleLoader::loadSDTitles(u32 numTitles) {
     PROFILE_SCOPE("Load SD Titles");
 
-    Result res;
-    if(numTitles == 0) {
+    std::vector<u64> ids;
+    if(numTitles == 0 || !sdTitleIDs(numTitles, ids)) {
         return;
     }
-    else if(numTitles == UINT32_MAX) {
-        if(R_FAILED(res = AM_GetTitleCount(MEDIATYPE_SD, &numTitles))) {
-            Logger::warn("Load SD Titles", "Failed to get title count");
-            Logger::warn("Load SD Titles", res);
-            return;
+
+    std::vector<LoadEntry> entries;
+    entries.reserve(ids.size());
+    for(u64 id : ids) {
+        entries.push_back({ .id = id, .snapshot = std::nullopt, .accessStamp = 0, .done = false, .title = nullptr });
+    }
+
+    loadQueuedTitles(std::move(entries));
+}
+
+void TitleLoader::loadQueuedTitles(std::vector<LoadEntry> entries) {
+    // one request for every title, lets titles with a current cache record skip opening their containers
+    std::vector<u64> ids;
+    for(const LoadEntry& entry : entries) {
+        if(!entry.snapshot.has_value()) {
+            ids.push_back(entry.id);
         }
     }
 
-    std::vector<u64> ids(numTitles);
-    if(R_FAILED(res = AM_GetTitleList(&numTitles, MEDIATYPE_SD, numTitles, ids.data()))) {
-        Logger::warn("Load SD Titles", "Failed to get SDCard title list");
+    std::vector<AM_TitleEntry> info(ids.size());
+    Result res;
+    if(!ids.empty() && R_FAILED(res = AM_GetTitleInfo(MEDIATYPE_SD, static_cast<u32>(ids.size()), ids.data(), info.data()))) {
+        Logger::warn("Load SD Titles", "Failed to get title info, probing every title");
         Logger::warn("Load SD Titles", res);
+    }
+    else {
+        size_t i = 0;
+        for(LoadEntry& entry : entries) {
+            if(!entry.snapshot.has_value()) {
+                entry.accessStamp = Title::accessStamp(info[i++]);
+            }
+        }
+    }
+
+    if(std::shared_ptr<const TitleOrder> order = m_order.load()) {
+        order->sort(entries, [](const LoadEntry& entry) { return entry.id; });
+    }
+
+    {
+        auto lock = m_loadQueueMutex.lock();
+
+        m_loadQueue   = std::move(entries);
+        m_nextLoad    = 0;
+        m_nextPublish = 0;
+    }
+
+    m_loadPool->start();
+    loadQueueMain();
+    // queue is empty or exiting early, helpers finish their current title
+    m_loadPool->waitForExit();
+
+    auto lock = m_loadQueueMutex.lock();
+    m_loadQueue.clear();
 
+    if(m_loaderWorker->waitingForExit()) {
+        Logger::info("Load SD Titles", "Exiting early");
+    }
+}
+
+bool TitleLoader::loadSnapshotTitles() {
+    PROFILE_SCOPE("Load Snapshot Titles");
+
+    std::shared_ptr<Cache> cache = Cache::instance();
+    std::vector<u8> data;
+    if(cache == nullptr || !cache->valid() || !cache->read(TitleSnapshot::CACHE_KEY, data)) {
+        return false;
+    }
+
+    std::vector<TitleSnapshot::Entry> snapshot;
+    u32 savedAt;
+
+    if(!TitleSnapshot::decode(data, snapshot, savedAt)) {
+        Logger::warn("Load Snapshot", "Title snapshot is invalid, loading from AM");
+        return false;
+    }
+
+    std::vector<LoadEntry> entries;
+    entries.reserve(snapshot.size());
+
+    {
+        auto lock = m_titlesMutex.lock();
+        for(const TitleSnapshot::Entry& entry : snapshot) {
+            if(entry.mediaType != MEDIATYPE_SD) {
+                continue;
+            }
+            else if(entry.accessible == 0) {
+                m_skippedTitles.push_back(entry.id);
+                m_titlesLoaded++;
+
+                continue;
+            }
+
+            entries.push_back({ .id = entry.id, .snapshot = entry, .accessStamp = 0, .done = false, .title = nullptr });
+        }
+    }
+
+    titlesLoadedChangedSignal(m_titlesLoaded);
+    Logger::info("Load Snapshot", "Loading {} titles from snapshot", entries.size());
+
+    m_savedSnapshot    = snapshot;
+    m_skippedCheckedAt = savedAt;
+    loadQueuedTitles(std::move(entries));
+
+    return true;
+}
+
+bool TitleLoader::reconcileSDTitles() {
+    PROFILE_SCOPE("Reconcile SD Titles");
+
+    const u32 checkedAt = PlayHistory::currentMinutes();
+
+    std::vector<u64> ids;
+    if(!sdTitleIDs(UINT32_MAX, ids)) {
+        return false;
+    }
+
+    const std::unordered_set<u64> installed(ids.begin(), ids.end());
+
+    // skipped titles can only have made a save or extdata by running
+    const std::shared_ptr<const PlayHistory> history = playHistory();
+
+    // only sd titles have cache records
+    std::vector<u64> removed;
+    std::unordered_set<u64> recheck;
+    std::vector<LoadEntry> entries;
+
+    {
+        auto lock = m_titlesMutex.lock();
+
+        std::unordered_set<u64> uninstalled;
+        for(auto it = m_titleIndex.begin(); it != m_titleIndex.end();) {
+            const auto& [key, title] = *it;
+            if(key.second != MEDIATYPE_SD || installed.contains(key.first)) {
+                it++;
+                continue;
+            }
+
+            title->setInvalid();
+            uninstalled.insert(key.first);
+            removed.push_back(key.first);
+
+            it = m_titleIndex.erase(it);
+        }
+
+        if(!uninstalled.empty()) {
+            std::erase_if(m_titles, [&uninstalled](const std::shared_ptr<Title>& title) { return title->mediaType() == MEDIATYPE_SD && uninstalled.contains(title->id()); });
+            publishTitles();
+        }
+
+        std::erase_if(m_skippedTitles, [&installed, &removed](u64 id) {
+            if(installed.contains(id)) {
+                return false;
+            }
+
+            removed.push_back(id);
+            return true;
+        });
+
+        for(u64 id : m_skippedTitles) {
+            if(history->playedSince(id, m_skippedCheckedAt)) {
+                recheck.insert(id);
+            }
+        }
+
+        std::erase_if(m_skippedTitles, [&recheck](u64 id) { return recheck.contains(id); });
+
+        const std::unordered_set<u64> skipped(m_skippedTitles.begin(), m_skippedTitles.end());
+        for(u64 id : ids) {
+            if(recheck.contains(id) || (!skipped.contains(id) && !m_titleIndex.contains({ id, MEDIATYPE_SD }))) {
+                entries.push_back({ .id = id, .snapshot = std::nullopt, .accessStamp = 0, .done = false, .title = nullptr });
+            }
+        }
+    }
+
+    m_skippedCheckedAt = checkedAt;
+    if(removed.empty() && entries.empty()) {
+        return false;
+    }
+
+    // dead records would never be compacted away
+    std::shared_ptr<Cache> cache = Cache::instance();
+    if(cache != nullptr && cache->valid()) {
+        for(u64 id : removed) {
+            if(!cache->remove(id)) {
+                Logger::warn("Reconcile SD Titles", "Failed to remove cache of {:X}", id);
+            }
+        }
+    }
+
+    // rechecked titles are counted again as they load
+    m_titlesLoaded -= removed.size() + recheck.size();
+    titlesLoadedChangedSignal(m_titlesLoaded);
+
+    Logger::info("Reconcile SD Titles", "Removed {} titles, loading {}", removed.size(), entries.size());
+    loadQueuedTitles(std::move(entries));
+
+    return true;
+}
+
+void TitleLoader::saveSnapshot() {
+    std::vector<TitleSnapshot::Entry> entries;
+
+    {
+        auto lock = m_titlesMutex.lock();
+        entries.reserve(m_titles.size() + m_skippedTitles.size());
+
+        for(const std::shared_ptr<Title>& title : m_titles) {
+            if(title == nullptr || !title->valid() || title->mediaType() != MEDIATYPE_SD) {
+                continue;
+            }
+
+            TitleSnapshot::Entry entry = {
+                .id         = title->id(),
+                .mediaType  = MEDIATYPE_SD,
+                .accessible = static_cast<u8>((title->containerAccessible(SAVE) ? SAVE : 0) | (title->containerAccessible(EXTDATA) ? EXTDATA : 0)),
+                .outOfDate  = title->outOfDate()
+            };
+
+            strncpy(entry.productCode, title->productCode(), sizeof(entry.productCode) - 1);
+            entries.push_back(entry);
+        }
+
+        for(u64 id : m_skippedTitles) {
+            entries.push_back({ .id = id, .mediaType = MEDIATYPE_SD });
+        }
+    }
+
+    // entries are fully zeroed past their fields so they can be compared directly
+    if(entries.size() == m_savedSnapshot.size() && memcmp(entries.data(), m_savedSnapshot.data(), entries.size() * sizeof(TitleSnapshot::Entry)) == 0) {
         return;
     }
 
-    for(u64 id : ids) {
-        Logger::info("Load SD Titles", "Loading {:X}", id);
+    std::shared_ptr<Cache> cache = Cache::instance();
+    if(cache == nullptr || !cache->valid() || !cache->write(TitleSnapshot::CACHE_KEY, TitleSnapshot::encode(entries, m_skippedCheckedAt))) {
+        Logger::warn("Save Snapshot", "Failed to save title snapshot");
+        return;
+    }
 
-        if(m_loaderWorker->waitingForExit()) {
-            Logger::info("Load SD Titles", "Exiting early");
-            return;
+    m_savedSnapshot = std::move(entries);
+}
+
+void TitleLoader::loadQueueMain() {
+    while(!m_loaderWorker->waitingForExit()) {
+        size_t index;
+        u64 id;
+        std::optional<TitleSnapshot::Entry> snapshot;
+        u64 accessStamp;
+
+        {
+            auto lock = m_loadQueueMutex.lock();
+            if(m_nextLoad >= m_loadQueue.size()) {
+                return;
+            }
+
+            index       = m_nextLoad++;
+            id          = m_loadQueue[index].id;
+            snapshot    = m_loadQueue[index].snapshot;
+            accessStamp = m_loadQueue[index].accessStamp;
         }
 
-        std::shared_ptr<Title> title = std::make_shared<Title>(id, MEDIATYPE_SD, CARD_CTR);
-        if(title != nullptr && title->valid()) {
-            auto lock = m_titlesMutex.lock();
-            m_titles.push_back(title);
+        std::shared_ptr<Title> title;
+        if(snapshot.has_value()) {
+            title = std::make_shared<Title>(*snapshot);
+        }
+        else {
+            Logger::info("Load SD Titles", "Loading {:X}", id);
+            title = std::make_shared<Title>(id, MEDIATYPE_SD, CARD_CTR, accessStamp);
+        }
+
+        {
+            auto lock = m_loadQueueMutex.lock();
+
+            LoadEntry& entry = m_loadQueue[index];
+            entry.done       = true;
+            entry.title      = title != nullptr && title->valid() ? title : nullptr;
+
+            // publish everything up to the first title still loading, keeps the list in AM order
+            auto titlesLock         = m_titlesMutex.lock();
+            const size_t titleCount = m_titles.size();
+            for(; m_nextPublish < m_loadQueue.size() && m_loadQueue[m_nextPublish].done; m_nextPublish++) {
+                LoadEntry& next = m_loadQueue[m_nextPublish];
+                if(next.title != nullptr) {
+                    m_titleIndex[{ next.id, MEDIATYPE_SD }] = next.title;
+                    m_titles.push_back(std::move(next.title));
+                }
+                else {
+                    m_skippedTitles.push_back(next.id);
+                }
+            }
+
+            if(m_titles.size() != titleCount) {
+                publishTitles();
+            }
         }
 
         titlesLoadedChangedSignal(++m_titlesLoaded);
@@ -169,68 +506,124 @@ void TitleLoader::loadSDTitles(u32 numTitles) {
 
 void TitleLoader::cardWorkerMain() {
     Logger::info("Card Worker", "Starting watcher");
-    constexpr s64 checkIntervalMS = 100;
+    const s64 checkIntervalMS = m_cardEvents->available() ? cardFallbackPollMS : cardPollMS;
 
+    // a card isn't readable straight after it's inserted, it's polled quickly for a while until it is
+    u32 settleChecks = 0;
+
+    // any event is checked the same way, a wake left over from a previous stop only causes an extra check
+    CardEventSource::Event event = CardEventSource::TIMEOUT;
     do {
         if(loadGameCardTitle()) {
             reloadHashes();
+            settleChecks = 0;
+        }
+        else if(event == CardEventSource::INSERTED) {
+            settleChecks = cardSettleChecks;
         }
-    } while(m_condVar.wait(checkIntervalMS * static_cast<s64>(1e+6)) != 0 && !m_cardWorker->waitingForExit());
+
+        s64 intervalMS = checkIntervalMS;
+        if(settleChecks > 0) {
+            intervalMS = cardPollMS;
+            settleChecks--;
+        }
+
+        event = m_cardEvents->wait(intervalMS * static_cast<s64>(1e+6));
+    } while(!m_cardWorker->waitingForExit());
+}
+
+void TitleLoader::stopCardWorker() {
+    m_cardWorker->signalShouldExit();
+    m_cardEvents->wake();
+
+    m_cardWorker->waitForExit();
 }
 
 void TitleLoader::loadWorkerMain() {
     Logger::info("Load Worker", "Loading titles");
     PROFILE_SCOPE("Load All Titles");
 
-    m_cardWorker->waitForExit();
+    stopCardWorker();
 
-    {
-        auto lock = m_titlesMutex.lock();
-        m_titles.clear();
-    }
+    std::shared_ptr<const PlayHistory> history = std::make_shared<const PlayHistory>();
+    m_history.store(history);
+    m_order.store(m_orderFactory(*history));
 
-    m_titlesLoaded = 0;
-    m_totalTitles  = 0;
+    // once the list has fully loaded only the differences with AM are applied, existing titles keep their icons, hashes and locks
+    const bool incremental = m_titlesComplete;
+    if(!incremental) {
+        auto lock = m_titlesMutex.lock();
 
-    u32 cardTitles = 0;
-    u32 sdTitles   = 0;
+        m_titles.clear();
+        m_titleIndex.clear();
+        m_skippedTitles.clear();
+        publishTitles();
 
-    Result res;
-    if(R_SUCCEEDED(res = AM_GetTitleCount(MEDIATYPE_GAME_CARD, &cardTitles))) {
-        m_totalTitles += cardTitles;
+        m_lastCardID       = 0;
+        m_titlesLoaded     = 0;
+        m_skippedCheckedAt = PlayHistory::currentMinutes();
     }
-    else {
-        Logger::warn("Load Worker", "Failed to get Game Card title count");
-        Logger::warn("Load Worker", res);
 
-        cardTitles = 0;
-    }
+    u32 sdTitles = 0;
 
-    if(R_SUCCEEDED(res = AM_GetTitleCount(MEDIATYPE_SD, &sdTitles))) {
-        m_totalTitles += sdTitles;
-    }
-    else {
+    Result res;
+    if(R_FAILED(res = AM_GetTitleCount(MEDIATYPE_SD, &sdTitles))) {
         Logger::warn("Load Worker", "Failed to get SD Card title count");
         Logger::warn("Load Worker", res);
 
         sdTitles = 0;
     }
 
-    titlesLoadedChangedSignal(m_titlesLoaded);
+    {
+        // the card title is counted as it's loaded
+        auto lock     = m_titlesMutex.lock();
+        m_totalTitles = sdTitles + (m_titleIndex.contains({ m_lastCardID, MEDIATYPE_GAME_CARD }) ? 1 : 0);
+    }
 
+    titlesLoadedChangedSignal(m_titlesLoaded);
     loadGameCardTitle();
-    loadSDTitles(sdTitles);
 
-    if(m_loaderWorker->waitingForExit()) {
-        Logger::info("Load Worker", "Exiting early");
-        return;
+    bool reconcile = incremental;
+    if(!incremental) {
+        reconcile = loadSnapshotTitles();
+        if(!reconcile) {
+            loadSDTitles(sdTitles);
+        }
+
+        if(m_loaderWorker->waitingForExit()) {
+            Logger::info("Load Worker", "Exiting early");
+            m_loadingTitles = false;
+
+            return;
+        }
+
+        Logger::info("Load Worker", "Loaded {} titles", m_titles.size());
+        m_loadingTitles  = false;
+        m_titlesComplete = true;
+
+        titlesFinishedLoadingSignal();
+        reloadHashes();
     }
 
-    Logger::info("Load Worker", "Loaded {} titles", m_titles.size());
-    titlesFinishedLoadingSignal();
-    reloadHashes();
+    // from a snapshot the list is already usable here, anything installed or removed since is applied in the background
+    if(reconcile && reconcileSDTitles()) {
+        if(m_loaderWorker->waitingForExit()) {
+            Logger::info("Load Worker", "Exiting early");
+            return;
+        }
+
+        Logger::info("Load Worker", "Reconciled to {} titles", m_titles.size());
+        titlesFinishedLoadingSignal();
+        reloadHashes();
+    }
+
+    m_loadingTitles = false;
+    saveSnapshot();
 
     m_cardWorker->start();
+    if(!m_cardWorker->running()) {
+        Logger::warn("Load Worker", "Failed to start card watcher, game cards won't be detected");
+    }
 }
 
 enum Priority {
@@ -243,30 +636,48 @@ void TitleLoader::hashWorkerMain() {
     Logger::info("Hash Worker", "Hashing all titles");
 
     PROFILE_SCOPE("Hash All Titles");
-    std::map<Priority, std::vector<std::pair<std::shared_ptr<Title>, Container>>> containers = {
+    std::map<Priority, std::vector<HashEntry>> containers = {
         { HIGH, {} },
         { MEDIUM, {} },
         { LOW, {} }
     };
 
-    std::vector<std::shared_ptr<Title>> titles;
-
-    {
-        auto lock = m_titlesMutex.lock();
-        titles    = m_titles;
+    // recently played first within each priority, they're the most likely to have changed
+    std::vector<std::shared_ptr<Title>> titles = this->titles()->titles;
+    if(std::shared_ptr<const TitleOrder> order = m_order.load()) {
+        order->sort(titles, [](const std::shared_ptr<Title>& title) { return title->id(); });
     }
 
+    // saves only change while their title runs, extdata can also be written by spotpass so it's always checked
+    const std::shared_ptr<const PlayHistory> history = playHistory();
+
     for(auto title : titles) {
         if(title == nullptr || !title->valid()) {
             continue;
         }
 
+        // accessibility can come from the cache, a title can only have made a save or extdata by running since
+        if(history->valid() && history->playedSince(title->id(), title->accessCheckedAt()) && title->probeAccessibility()) {
+            Logger::info("Hash Worker", "Containers of {:X} changed", title->id());
+        }
+
         for(Container type : { SAVE, EXTDATA }) {
             if(m_hashWorker->waitingForExit()) {
                 Logger::info("Hash Worker", "Exiting early");
                 return;
             }
 
+            bool skipUnchanged = false;
+            if(type == SAVE && history->valid()) {
+                const u32 lastHashed = title->lastHashed(type);
+                if(lastHashed == 0 || history->playedSince(title->id(), lastHashed)) {
+                    title->markContainerChanged(type);
+                }
+                else {
+                    skipUnchanged = true;
+                }
+            }
+
             std::vector<FileInfo> files;
             {
                 // this will wait for any operation to be done
@@ -284,8 +695,8 @@ void TitleLoader::hashWorkerMain() {
                     allHashed = false;
                     break;
                 }
-                // make medium priority if should update
-                else if(file._shouldUpdateHash) {
+                // make medium priority if should update or hashed with an algorithm the server no longer uses
+                else if(file._shouldUpdateHash || file.hashAlgorithm != Hasher::preferred()) {
                     allHashed  = false;
                     hasAnyHash = true;
                     break;
@@ -294,27 +705,85 @@ void TitleLoader::hashWorkerMain() {
                 hasAnyHash = true;
             }
 
-            containers[hasAnyHash ? (allHashed ? LOW : MEDIUM) : HIGH].push_back({ title, type });
+            containers[hasAnyHash ? (allHashed ? LOW : MEDIUM) : HIGH].push_back({ title, type, skipUnchanged });
         }
     }
 
-    for(const auto& entry : containers) {
-        for(const auto& pair : entry.second) {
-            pair.first->hashContainer(pair.second);
+    size_t queued = 0;
+    {
+        auto lock = m_hashQueueMutex.lock();
+        m_hashQueue.clear();
 
-            if(m_hashWorker->waitingForExit()) {
-                Logger::info("Hash Worker", "Exiting early");
+        for(const auto& entry : containers) {
+            m_hashQueue.insert(m_hashQueue.end(), entry.second.begin(), entry.second.end());
+        }
+
+        queued = m_hashQueue.size();
+    }
+
+    if(hashOnSysCore) {
+        APT_SetAppCpuTimeLimit(hashingAppCpuTimeLimit);
+    }
+
+    const size_t helpers = m_hashPool->start();
+    if(helpers < m_hashPool->size()) {
+        Logger::warn("Hash Worker", "Only {} of {} helpers started", helpers, m_hashPool->size());
+    }
+
+    Logger::info("Hash Worker", "Hashing {} containers with {} helpers", queued, helpers);
+    hashQueueMain();
+    // queue is empty or exiting early, helpers finish their current container
+    m_hashPool->waitForExit();
+
+    if(hashOnSysCore) {
+        APT_SetAppCpuTimeLimit(defaultAppCpuTimeLimit);
+    }
+
+    if(m_hashWorker->waitingForExit()) {
+        Logger::info("Hash Worker", "Exiting early");
+        return;
+    }
+
+    Logger::info("Hash Worker", "Hashed all titles");
+}
+
+void TitleLoader::hashQueueMain() {
+    // each hashing thread keeps one pipeline for all the containers it takes, its reader stays on this thread's core
+    ReadPipeline pipeline(HASH_READ_SIZE, Worker::currentProcessor());
+
+    while(!m_hashWorker->waitingForExit()) {
+        HashEntry entry;
+
+        {
+            auto lock = m_hashQueueMutex.lock();
+            if(m_hashQueue.empty()) {
                 return;
             }
 
-            titleHashedSignal(pair.first, pair.second);
+            entry = m_hashQueue.front();
+            m_hashQueue.pop_front();
         }
+
+        entry.title->hashContainer(entry.container, &pipeline, entry.skipUnchanged);
+        if(m_hashWorker->waitingForExit()) {
+            return;
+        }
+
+        titleHashedSignal(entry.title, entry.container);
     }
+}
 
-    Logger::info("Hash Worker", "Hashed all titles");
+void TitleLoader::publishTitles() {
+    std::shared_ptr<TitleList> list = std::make_shared<TitleList>();
+    list->version                   = m_publishedTitles.load()->version + 1;
+    list->titles                    = m_titles;
+
+    m_publishedTitles.store(std::move(list));
 }
 
-std::vector<std::shared_ptr<Title>> TitleLoader::titles() {
-    auto lock = m_titlesMutex.lock();
-    return m_titles;
+std::shared_ptr<const TitleList> TitleLoader::titles() const { return m_publishedTitles.load(); }
+
+std::shared_ptr<const PlayHistory> TitleLoader::playHistory() const {
+    std::shared_ptr<const PlayHistory> history = m_history.load();
+    return history != nullptr ? history : std::make_shared<const PlayHistory>();
 }
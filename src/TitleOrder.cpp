@@ -0,0 +1,18 @@
+#include <TitleOrder.hpp>
+
+TitleOrderFactory TitleOrder::recentlyPlayed(u64 lastSelected) {
+    return [lastSelected](const PlayHistory& history) { return std::make_shared<const RecentlyPlayedOrder>(history, lastSelected); };
+}
+
+RecentlyPlayedOrder::RecentlyPlayedOrder(const PlayHistory& history, u64 lastSelected)
+    : m_history(history)
+    , m_lastSelected(lastSelected) {}
+
+u64 RecentlyPlayedOrder::priority(u64 id) const {
+    if(id == m_lastSelected && id != 0) {
+        return U64_MAX;
+    }
+
+    // an invalid history has nothing in it, everything keeps its AM order
+    return m_history.lastPlayed(id);
+}
@@ -0,0 +1,52 @@
+#include <TitleSnapshot.hpp>
+#include <string.h>
+#include <zlib.h>
+
+namespace TitleSnapshot {
+
+std::vector<u8> encode(const std::vector<Entry>& entries, u32 savedAt) {
+    Header header     = {};
+    header.version    = VERSION;
+    header.headerSize = sizeof(Header);
+    header.entryCount = static_cast<u32>(entries.size());
+    header.entrySize  = sizeof(Entry);
+    header.savedAt    = savedAt;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+
+    std::vector<u8> out(sizeof(Header) + entries.size() * sizeof(Entry));
+    memcpy(out.data() + sizeof(Header), entries.data(), entries.size() * sizeof(Entry));
+
+    header.checksum = crc32(0, out.data() + sizeof(Header), static_cast<uInt>(out.size() - sizeof(Header)));
+    memcpy(out.data(), &header, sizeof(Header));
+
+    return out;
+}
+
+bool decode(const std::vector<u8>& data, std::vector<Entry>& out, u32& savedAt) {
+    Header header;
+    if(data.size() < sizeof(Header)) {
+        return false;
+    }
+
+    memcpy(&header, data.data(), sizeof(Header));
+    if(memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.headerSize != sizeof(Header) || header.entrySize != sizeof(Entry)) {
+        return false;
+    }
+
+    // checked as u64 so a corrupt count can't overflow past the bounds check
+    if(sizeof(Header) + static_cast<u64>(header.entryCount) * sizeof(Entry) != data.size()) {
+        return false;
+    }
+
+    if(crc32(0, data.data() + sizeof(Header), static_cast<uInt>(data.size() - sizeof(Header))) != header.checksum) {
+        return false;
+    }
+
+    out.resize(header.entryCount);
+    memcpy(out.data(), data.data() + sizeof(Header), out.size() * sizeof(Entry));
+    savedAt = header.savedAt;
+
+    return true;
+}
+
+}; // namespace TitleSnapshot
@@ -42,7 +42,9 @@ MainScreen::MainScreen(std::shared_ptr<Config> config, std::shared_ptr<TitleLoad
     : m_config(config)
     , m_loader(loader)
     , m_client(client)
+    , m_titles(loader->titles())
     , m_settingsScreen(std::make_unique<SettingsScreen>(config))
+    , m_iconLoader(std::make_unique<IconLoader>())
     , m_selectedTitle(0) {
     // TODO: fix unmapped read with signals
     m_client->networkQueueChangedSignal.connect<&MainScreen::updateQueuedText>(this);
@@ -50,6 +52,12 @@ MainScreen::MainScreen(std::shared_ptr<Config> config, std::shared_ptr<TitleLoad
     m_client->requestFailedSignal.connect<&MainScreen::onClientRequestFailed>(this);
 }
 
+MainScreen::~MainScreen() {
+    if(!m_loader->isLoadingTitles() && m_selectedTitle < m_titles->titles.size()) {
+        m_config->lastTitle()->setValue(m_titles->titles[m_selectedTitle]->id());
+    }
+}
+
 void MainScreen::scrollToCurrent() {
     u16 selectedRow = m_selectedTitle / m_cols;
     if(selectedRow < m_scroll) {
@@ -63,11 +71,11 @@ void MainScreen::scrollToCurrent() {
 }
 
 void MainScreen::tryUpload(Container titleContainer) {
-    if(m_selectedTitle >= m_loader->titles().size()) {
+    if(m_selectedTitle >= m_titles->titles.size()) {
         return;
     }
 
-    auto title = m_loader->titles()[m_selectedTitle];
+    auto title = m_titles->titles[m_selectedTitle];
     if(!title->containerAccessible(titleContainer) || title->getContainerFiles(titleContainer).empty()) {
         return;
     }
@@ -80,11 +88,11 @@ void MainScreen::tryUpload(Container titleContainer) {
 }
 
 void MainScreen::tryDownload(Container titleContainer) {
-    if(m_selectedTitle >= m_loader->titles().size()) {
+    if(m_selectedTitle >= m_titles->titles.size()) {
         return;
     }
 
-    auto title = m_loader->titles()[m_selectedTitle];
+    auto title = m_titles->titles[m_selectedTitle];
     if(!title->containerAccessible(titleContainer)) {
         return;
     }
@@ -97,6 +105,8 @@ void MainScreen::tryDownload(Container titleContainer) {
 }
 
 void MainScreen::update() {
+    m_titles = m_loader->titles();
+
     if(m_settingsScreen->isActive()) {
         m_settingsScreen->update();
         return;
@@ -174,16 +184,16 @@ void MainScreen::update() {
     }
 
     if(changed) {
-        m_selectedTitle = std::clamp(m_selectedTitle, static_cast<size_t>(0), m_loader->titles().size() - 1);
+        m_selectedTitle = std::clamp(m_selectedTitle, static_cast<size_t>(0), m_titles->titles.size() - 1);
     }
 
     std::shared_ptr<Title> title = nullptr;
-    if(m_selectedTitle < m_loader->titles().size()) {
-        title = m_loader->titles()[m_selectedTitle];
+    if(m_selectedTitle < m_titles->titles.size()) {
+        title = m_titles->titles[m_selectedTitle];
     }
-    else if(!m_loader->titles().empty()) {
+    else if(!m_titles->titles.empty()) {
         m_selectedTitle = 0;
-        title           = m_loader->titles().front();
+        title           = m_titles->titles.front();
     }
 
     if(kHeld & KEY_L && kDown & KEY_A && title != nullptr) {
@@ -310,9 +320,11 @@ Clay_Color borderColor(u8 timerID) {
     )
 
 const u16 iconGap = 2;
+// rows of icons loaded ahead above and below the visible ones
+const u16 iconPrefetchRows = 2;
 
 static CustomElementData circleData = { .type = CUSTOM_ELEMENT_TYPE_CIRCLE };
-void MainScreen::TitleIcon(std::shared_ptr<Title> title, float width, float height, Clay_BorderElementConfig border) {
+void MainScreen::TitleIcon(const std::shared_ptr<Title>& title, float width, float height, Clay_BorderElementConfig border) {
     CLAY_AUTO_ID({ .layout = { .sizing = { .width = CLAY_SIZING_FIXED(width), .height = CLAY_SIZING_FIXED(height) } }, .image = { .imageData = title->icon() }, .border = border }) {
         Clay_Color color = Theme::Unknown();
         if(m_client->cachedTitleInfoLoaded()) {
@@ -345,6 +357,43 @@ void MainScreen::TitleIcon(std::shared_ptr<Title> title, float width, float heig
     }
 }
 
+void MainScreen::requestIcons(const std::vector<std::shared_ptr<Title>>& titles) {
+    if(m_cols == 0) {
+        return;
+    }
+
+    // both the rows drawn this frame and the ones scrolled to for the next
+    const size_t firstRow = std::min(m_scroll, m_renderedScroll);
+    const size_t lastRow  = std::max(m_scroll, m_renderedScroll) + m_visibleRows;
+
+    std::vector<std::shared_ptr<Title>> requested;
+    auto addRow = [&](size_t row) {
+        for(size_t i = row * m_cols; i < std::min((row + 1) * m_cols, titles.size()); i++) {
+            requested.push_back(titles[i]);
+        }
+    };
+
+    // the selected icon is also on the bottom screen
+    const size_t selectedRow = m_selectedTitle / m_cols;
+    if(m_selectedTitle < titles.size() && (selectedRow < firstRow || selectedRow >= lastRow)) {
+        requested.push_back(titles[m_selectedTitle]);
+    }
+
+    for(size_t row = firstRow; row < lastRow; row++) {
+        addRow(row);
+    }
+
+    // nearest rows first
+    for(size_t offset = 1; offset <= iconPrefetchRows; offset++) {
+        addRow(lastRow - 1 + offset);
+        if(firstRow >= offset) {
+            addRow(firstRow - offset);
+        }
+    }
+
+    m_iconLoader->request(requested);
+}
+
 inline void MainScreen::GridLayout() {
     Clay_ElementData data = Clay_GetElementData(CLAY_ID("Titles"));
     if(!data.found || data.boundingBox.width == 0.0f || data.boundingBox.height == 0.0f) {
@@ -352,15 +401,16 @@ inline void MainScreen::GridLayout() {
     }
 
     m_cols        = floor((data.boundingBox.width + iconGap) / (SMDH::ICON_WIDTH + iconGap));
-    m_rows        = ceil(m_loader->titles().size() / static_cast<float>(m_cols));
+    m_rows        = ceil(m_titles->titles.size() / static_cast<float>(m_cols));
     m_visibleRows = floor((data.boundingBox.height + iconGap) / (SMDH::ICON_HEIGHT + iconGap));
     scrollToCurrent();
+    requestIcons(m_titles->titles);
 
-    for(size_t titleIdx = 0; titleIdx < m_loader->titles().size();) {
+    for(size_t titleIdx = 0; titleIdx < m_titles->titles.size();) {
         CLAY_AUTO_ID({ .layout = { .padding = { 1, 1, 0, 0 } } }) {
             CLAY_AUTO_ID({ .layout = { .childGap = iconGap } }) {
-                for(bool first = true; titleIdx < m_loader->titles().size() && !(!first && titleIdx % m_cols == 0); titleIdx++, first = false) {
-                    TitleIcon(m_loader->titles()[titleIdx], SMDH::ICON_WIDTH, SMDH::ICON_HEIGHT, titleIdx == m_selectedTitle ? Clay_BorderElementConfig{ .color = borderColor(0), .width = CLAY_BORDER_OUTSIDE(1) } : Clay_BorderElementConfig{});
+                for(bool first = true; titleIdx < m_titles->titles.size() && !(!first && titleIdx % m_cols == 0); titleIdx++, first = false) {
+                    TitleIcon(m_titles->titles[titleIdx], SMDH::ICON_WIDTH, SMDH::ICON_HEIGHT, titleIdx == m_selectedTitle ? Clay_BorderElementConfig{ .color = borderColor(0), .width = CLAY_BORDER_OUTSIDE(1) } : Clay_BorderElementConfig{});
                 }
             }
         }
@@ -374,16 +424,17 @@ void MainScreen::ListLayout() {
     }
 
     m_cols        = 1;
-    m_rows        = m_loader->titles().size();
+    m_rows        = m_titles->titles.size();
     m_visibleRows = floor((data.boundingBox.height + iconGap) / (SMDH::ICON_HEIGHT + iconGap));
 
     scrollToCurrent();
+    requestIcons(m_titles->titles);
 
     const u16 padding      = 2;
     size_t titleTextOffset = 0;
 
-    for(size_t i = 0; i < m_loader->titles().size(); i++) {
-        auto title = m_loader->titles()[i];
+    for(size_t i = 0; i < m_titles->titles.size(); i++) {
+        const std::shared_ptr<Title>& title = m_titles->titles[i];
 
         CLAY_AUTO_ID({
             .layout = {
@@ -403,7 +454,7 @@ void MainScreen::ListLayout() {
             Clay_String str         = { .isStaticallyAllocated = false, .length = static_cast<int32_t>(text.size()), .chars = m_titleTexts.c_str() + titleTextOffset };
 
             if(m_titleTexts.size() < titleTextOffset + text.size()) {
-                i = m_loader->titles().size();
+                i = m_titles->titles.size();
                 goto skipTitle;
             }
 
@@ -447,13 +498,17 @@ void MainScreen::renderTop() {
         m_loadedText   = std::format("{}/{} Loaded", loadedTitles, m_loader->totalTitles());
         m_loadedString = { .isStaticallyAllocated = false, .length = static_cast<int32_t>(m_loadedText.size()), .chars = m_loadedText.c_str() };
 
+        m_prevLoadedTitles = loadedTitles;
+    }
+
+    if(m_titleTextsVersion != m_titles->version) {
         m_titleTexts.clear();
 
-        for(auto title : m_loader->titles()) {
+        for(auto title : m_titles->titles) {
             m_titleTexts += title->longDescription();
         }
 
-        m_prevLoadedTitles = loadedTitles;
+        m_titleTextsVersion = m_titles->version;
     }
 
     CLAY(
@@ -630,14 +685,14 @@ void MainScreen::renderBottom() {
         std::shared_ptr<Title> title;
         if(
             m_loader->isLoadingTitles() ||
-            m_loader->titles().size() <= m_selectedTitle ||
-            m_loader->titles()[m_selectedTitle] == nullptr
+            m_titles->titles.size() <= m_selectedTitle ||
+            m_titles->titles[m_selectedTitle] == nullptr
         ) {
             VSPACER();
             goto skipTitle;
         }
 
-        title = m_loader->titles()[m_selectedTitle];
+        title = m_titles->titles[m_selectedTitle];
         CLAY(CLAY_ID("Details"), { .layout = { .sizing = { .width = CLAY_SIZING_PERCENT(1.0) }, .padding = CLAY_PADDING_ALL(2) } }) {
             CLAY(CLAY_ID("Info"), { .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
                 CLAY_AUTO_ID({ .layout = { .childGap = 1, .childAlignment = { .y = CLAY_ALIGN_Y_CENTER } } }) {
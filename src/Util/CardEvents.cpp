@@ -0,0 +1,88 @@
+#include <Debug/Logger.hpp>
+#include <Util/CardEvents.hpp>
+
+// sent by ns to subscribed processes
+constexpr u32 cardInsertedNotification = 0x210;
+constexpr u32 cardRemovedNotification  = 0x211;
+
+class NotificationCardEventSource : public CardEventSource {
+public:
+    NotificationCardEventSource()
+        : m_available(false)
+        , m_wakeEvent(0)
+        , m_notifications(0) {
+        svcCreateEvent(&m_wakeEvent, RESET_ONESHOT);
+
+        Result res;
+        if(R_FAILED(res = srvEnableNotification(&m_notifications))) {
+            Logger::warn("Card Events", "Failed to enable notifications, polling the card instead");
+            Logger::warn("Card Events", res);
+
+            m_notifications = 0;
+            return;
+        }
+
+        for(u32 notification : { cardInsertedNotification, cardRemovedNotification }) {
+            if(R_FAILED(res = srvSubscribe(notification))) {
+                Logger::warn("Card Events", "Failed to subscribe to {:X}, polling the card instead", notification);
+                Logger::warn("Card Events", res);
+
+                return;
+            }
+        }
+
+        m_available = true;
+    }
+
+    ~NotificationCardEventSource() override {
+        if(m_notifications != 0) {
+            srvUnsubscribe(cardInsertedNotification);
+            srvUnsubscribe(cardRemovedNotification);
+
+            svcCloseHandle(m_notifications);
+        }
+
+        svcCloseHandle(m_wakeEvent);
+    }
+
+    bool available() const override { return m_available; }
+
+    Event wait(s64 timeoutNS) override {
+        if(!m_available) {
+            return svcWaitSynchronization(m_wakeEvent, timeoutNS) == 0 ? WOKEN : TIMEOUT;
+        }
+
+        // a timeout isn't a failure code, only zero means a handle was signaled
+        const Handle handles[] = { m_wakeEvent, m_notifications };
+        s32 index;
+        if(svcWaitSynchronizationN(&index, handles, 2, false, timeoutNS) != 0) {
+            return TIMEOUT;
+        }
+        else if(index == 0) {
+            return WOKEN;
+        }
+
+        u32 notification;
+        if(R_FAILED(srvReceiveNotification(&notification))) {
+            return TIMEOUT;
+        }
+
+        switch(notification) {
+        case cardInsertedNotification: return INSERTED;
+        case cardRemovedNotification:  return REMOVED;
+        // anything else srv sends everyone, e.g. termination which apt already handles
+        default:                       return TIMEOUT;
+        }
+    }
+
+    void wake() override { svcSignalEvent(m_wakeEvent); }
+
+private:
+    bool m_available;
+
+    Handle m_wakeEvent;
+    // semaphore released for each pending notification
+    Handle m_notifications;
+};
+
+std::unique_ptr<CardEventSource> CardEventSource::create() { return std::make_unique<NotificationCardEventSource>(); }
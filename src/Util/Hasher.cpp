@@ -0,0 +1,99 @@
+#include <Util/Hasher.hpp>
+#include <atomic>
+#include <md5.h>
+#include <string.h>
+#include <xxh64.h>
+
+// seed is part of the digest the server stores, it can't change either
+constexpr u64 xxh64Seed = 0;
+
+static std::atomic<HashAlgorithm> s_preferred = HashAlgorithm::MD5;
+
+HashAlgorithm Hasher::preferred() { return s_preferred; }
+void Hasher::setPreferred(HashAlgorithm algorithm) { s_preferred = algorithm; }
+
+static std::string toHex(const u8* digest, u8 size) {
+    constexpr char digits[] = "0123456789abcdef";
+
+    std::string out(size * 2u, '\0');
+    for(size_t i = 0; i < size; i++) {
+        out[i * 2]     = digits[digest[i] >> 4];
+        out[i * 2 + 1] = digits[digest[i] & 0xF];
+    }
+
+    return out;
+}
+
+class MD5Hasher : public Hasher {
+public:
+    MD5Hasher() { md5Init(&m_ctx); }
+
+    HashAlgorithm algorithm() const override { return HashAlgorithm::MD5; }
+
+    void update(const u8* data, u32 size) override { md5Update(&m_ctx, data, size); }
+    std::string finalize() override {
+        md5Finalize(&m_ctx);
+        return toHex(m_ctx.digest, sizeof(m_ctx.digest));
+    }
+
+    bool resumable() const override { return true; }
+    void saveState(u32 (&state)[4]) const override { memcpy(state, m_ctx.buffer, sizeof(state)); }
+    void restoreState(const u32 (&state)[4], u64 size) override {
+        memcpy(m_ctx.buffer, state, sizeof(state));
+        m_ctx.size = size;
+    }
+
+private:
+    MD5Context m_ctx;
+};
+
+class XXH64Hasher : public Hasher {
+public:
+    XXH64Hasher() { xxh64Init(&m_ctx, xxh64Seed); }
+
+    HashAlgorithm algorithm() const override { return HashAlgorithm::XXH64; }
+
+    void update(const u8* data, u32 size) override { xxh64Update(&m_ctx, data, size); }
+    std::string finalize() override {
+        xxh64Finalize(&m_ctx);
+        return toHex(m_ctx.digest, sizeof(m_ctx.digest));
+    }
+
+private:
+    XXH64Context m_ctx;
+};
+
+std::unique_ptr<Hasher> Hasher::create(HashAlgorithm algorithm) {
+    switch(algorithm) {
+    case HashAlgorithm::MD5:   return std::make_unique<MD5Hasher>();
+    case HashAlgorithm::XXH64: return std::make_unique<XXH64Hasher>();
+    default:                   return nullptr;
+    }
+}
+
+const char* Hasher::name(HashAlgorithm algorithm) {
+    switch(algorithm) {
+    case HashAlgorithm::MD5:   return "md5";
+    case HashAlgorithm::XXH64: return "xxh64";
+    default:                   return "";
+    }
+}
+
+bool Hasher::fromName(const char* name, HashAlgorithm& out) {
+    for(HashAlgorithm algorithm : { HashAlgorithm::MD5, HashAlgorithm::XXH64 }) {
+        if(strcmp(name, Hasher::name(algorithm)) == 0) {
+            out = algorithm;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+u8 Hasher::digestSize(HashAlgorithm algorithm) {
+    switch(algorithm) {
+    case HashAlgorithm::MD5:   return 16;
+    case HashAlgorithm::XXH64: return 8;
+    default:                   return 0;
+    }
+}
@@ -0,0 +1,123 @@
+#include <Debug/Logger.hpp>
+#include <Util/IconAtlas.hpp>
+#include <string.h>
+
+// one row of tiles across the slot, textures are stored as 8x8 tiles a row of tiles at a time
+static constexpr size_t SLOT_TILE_ROW = SMDH::ICON_WIDTH * 8;
+static constexpr size_t PAGE_TILE_ROW = IconAtlas::PAGE_WIDTH * 8;
+
+IconAtlas::Slot::Slot(std::shared_ptr<Page> page, u16 index) noexcept
+    : m_page(page)
+    , m_index(index) {
+    const u16 x = (index % SLOT_COLUMNS) * SMDH::ICON_WIDTH;
+    const u16 y = (index / SLOT_COLUMNS) * SMDH::ICON_HEIGHT;
+
+    m_subtex = {
+        SMDH::ICON_WIDTH,
+        SMDH::ICON_HEIGHT,
+        x / static_cast<float>(PAGE_WIDTH),
+        1.0f - y / static_cast<float>(PAGE_HEIGHT),
+        (x + SMDH::ICON_WIDTH) / static_cast<float>(PAGE_WIDTH),
+        1.0f - (y + SMDH::ICON_HEIGHT) / static_cast<float>(PAGE_HEIGHT)
+    };
+}
+
+IconAtlas::Slot::~Slot() {
+    auto lock = m_page->mutex.lock();
+    m_page->freeSlots.push_back(m_index);
+}
+
+C2D_Image IconAtlas::Slot::image() { return C2D_Image{ m_page->tex->handle(), &m_subtex }; }
+
+u16* IconAtlas::Slot::data() const {
+    const u16 tileX = (m_index % SLOT_COLUMNS) * (SMDH::ICON_WIDTH / 8);
+    const u16 tileY = (m_index / SLOT_COLUMNS) * (SMDH::ICON_HEIGHT / 8);
+
+    return reinterpret_cast<u16*>(m_page->tex->handle()->data) + tileY * PAGE_TILE_ROW + tileX * 8 * 8;
+}
+
+void IconAtlas::Slot::read(u16* iconData) const {
+    const u16* src = data();
+    for(u16 j = 0; j < SMDH::ICON_HEIGHT; j += 8) {
+        memcpy(iconData, src, SLOT_TILE_ROW * sizeof(u16));
+
+        src += PAGE_TILE_ROW;
+        iconData += SLOT_TILE_ROW;
+    }
+}
+
+IconAtlas::IconAtlas() {}
+
+std::shared_ptr<IconAtlas::Page> IconAtlas::createPage() {
+    std::shared_ptr<Page> page = std::make_shared<Page>();
+
+    page->tex = TexWrapper::create(PAGE_WIDTH, PAGE_HEIGHT, GPU_RGB565);
+    if(page->tex->handle()->data == nullptr) {
+        Logger::warn("Icon Atlas", "Failed to allocate page {}", m_pages.size());
+        return nullptr;
+    }
+
+    page->freeSlots.reserve(SLOTS_PER_PAGE);
+    for(u16 i = SLOTS_PER_PAGE; i > 0; i--) {
+        page->freeSlots.push_back(i - 1);
+    }
+
+    m_pages.push_back(page);
+    return page;
+}
+
+std::shared_ptr<IconAtlas::Slot> IconAtlas::add(const u16* iconData) {
+    struct make_shared_enabler : public Slot {
+        make_shared_enabler(std::shared_ptr<Page> page, u16 index) noexcept
+            : Slot(page, index) {}
+    };
+
+    std::shared_ptr<Slot> slot;
+
+    // earlier pages first, icons drawn together then tend to share a texture
+    for(const std::shared_ptr<Page>& page : m_pages) {
+        auto lock = page->mutex.lock();
+        if(page->freeSlots.empty()) {
+            continue;
+        }
+
+        slot = std::make_shared<make_shared_enabler>(page, page->freeSlots.back());
+        page->freeSlots.pop_back();
+
+        break;
+    }
+
+    if(slot == nullptr) {
+        std::shared_ptr<Page> page = createPage();
+        if(page == nullptr) {
+            return nullptr;
+        }
+
+        auto lock = page->mutex.lock();
+        slot      = std::make_shared<make_shared_enabler>(page, page->freeSlots.back());
+        page->freeSlots.pop_back();
+    }
+
+    u16* dst       = slot->data();
+    const u16* src = iconData;
+    for(u16 j = 0; j < SMDH::ICON_HEIGHT; j += 8) {
+        memcpy(dst, src, SLOT_TILE_ROW * sizeof(u16));
+
+        src += SLOT_TILE_ROW;
+        dst += PAGE_TILE_ROW;
+    }
+
+    // only the tile rows the slot covers
+    GSPGPU_FlushDataCache(slot->data(), ((SMDH::ICON_HEIGHT / 8 - 1) * PAGE_TILE_ROW + SLOT_TILE_ROW) * sizeof(u16));
+
+    return slot;
+}
+
+void IconAtlas::trim() {
+    std::erase_if(m_pages, [](const std::shared_ptr<Page>& page) {
+        auto lock = page->mutex.lock();
+        return page->freeSlots.size() == SLOTS_PER_PAGE;
+    });
+}
+
+size_t IconAtlas::pageCount() const { return m_pages.size(); }
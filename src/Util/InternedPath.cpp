@@ -0,0 +1,141 @@
+#include <Debug/Logger.hpp>
+#include <Util/InternedPath.hpp>
+#include <Util/Mutex.hpp>
+#include <Util/StringUtil.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+// paths are copied into large blocks so each one isn't its own allocation, views into them never move
+class PathArena {
+public:
+    static constexpr size_t BLOCK_SIZE = 0x4000;
+
+    std::string_view store(std::string_view path) {
+        if(path.size() > BLOCK_SIZE - m_blockUsed) {
+            // paths longer than a block get one to themselves
+            m_blocks.push_back(std::make_unique<char[]>(std::max(path.size(), BLOCK_SIZE)));
+            m_blockUsed = 0;
+        }
+
+        char* data = m_blocks.back().get() + m_blockUsed;
+        memcpy(data, path.data(), path.size());
+
+        m_blockUsed += path.size();
+        m_bytes += path.size();
+
+        return std::string_view(data, path.size());
+    }
+
+    size_t bytes() const { return m_bytes; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    // starts full so the first path allocates a block
+    size_t m_blockUsed = BLOCK_SIZE;
+    size_t m_bytes     = 0;
+};
+
+// views by id in fixed size chunks that are never moved, so an id can be looked up without the mutex
+// an id is only handed out after its view is stored
+class PathIndex {
+public:
+    static constexpr u32 CHUNK_SIZE = 0x400;
+    static constexpr u32 MAX_CHUNKS = 0x400;
+
+    PathIndex() {
+        for(std::atomic<std::string_view*>& chunk : m_chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~PathIndex() {
+        for(std::atomic<std::string_view*>& chunk : m_chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    u32 size() const { return m_size; }
+    bool full() const { return m_size == CHUNK_SIZE * MAX_CHUNKS; }
+
+    // expects the table mutex to be held and the index to not be full
+    u32 push(std::string_view path) {
+        const u32 id = m_size++;
+
+        std::string_view* chunk = m_chunks[id / CHUNK_SIZE].load(std::memory_order_relaxed);
+        if(chunk == nullptr) {
+            chunk = new std::string_view[CHUNK_SIZE];
+            m_chunks[id / CHUNK_SIZE].store(chunk, std::memory_order_release);
+        }
+
+        chunk[id % CHUNK_SIZE] = path;
+        return id;
+    }
+
+    std::string_view operator[](u32 id) const { return m_chunks[id / CHUNK_SIZE].load(std::memory_order_acquire)[id % CHUNK_SIZE]; }
+
+private:
+    std::atomic<std::string_view*> m_chunks[MAX_CHUNKS];
+    // only changed with the table mutex held
+    u32 m_size = 0;
+};
+
+struct PathTable {
+    PathTable() {
+        paths.push(std::string_view());
+        ids.emplace(std::string_view(), 0);
+    }
+
+    // only taken to intern a path
+    Mutex mutex;
+    PathArena arena;
+
+    PathIndex paths;
+    std::unordered_map<std::string_view, u32> ids;
+};
+
+// made on first use, paths can be interned during static initialization
+static PathTable& table() {
+    static PathTable s_table;
+    return s_table;
+}
+
+InternedPath::InternedPath()
+    : m_id(0) {}
+
+InternedPath::InternedPath(std::string_view utf8) {
+    PathTable& paths = table();
+    auto lock        = paths.mutex.lock();
+
+    auto it = paths.ids.find(utf8);
+    if(it != paths.ids.end()) {
+        m_id = it->second;
+        return;
+    }
+
+    if(paths.paths.full()) {
+        Logger::error("Interned Path", "Path table is full, using the empty path");
+
+        m_id = 0;
+        return;
+    }
+
+    const std::string_view stored = paths.arena.store(utf8);
+    m_id                          = paths.paths.push(stored);
+
+    paths.ids.emplace(stored, m_id);
+}
+
+InternedPath InternedPath::fromUTF16(const std::u16string& utf16) { return InternedPath(StringUtil::toUTF8(utf16)); }
+
+u32 InternedPath::id() const { return m_id; }
+
+std::string_view InternedPath::utf8() const { return table().paths[m_id]; }
+
+std::u16string InternedPath::utf16() const { return StringUtil::fromUTF8(std::string(utf8())); }
+
+bool InternedPath::operator==(const InternedPath& other) const { return m_id == other.m_id; }
+bool InternedPath::operator<(const InternedPath& other) const { return m_id != other.m_id && utf8() < other.utf8(); }
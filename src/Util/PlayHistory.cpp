@@ -0,0 +1,124 @@
+#include <Debug/Logger.hpp>
+#include <Debug/Profiler.hpp>
+#include <Util/Mutex.hpp>
+#include <Util/PlayHistory.hpp>
+#include <algorithm>
+#include <memory>
+
+// osGetTime counts from 1900, the log from 2000
+constexpr u64 minutesFrom1900To2000 = 36524ULL * 24 * 60;
+
+// ptmPlaysInit returns before the handle exists for a second caller, only one history is read at a time
+static Mutex s_ptmMutex;
+
+u32 PlayHistory::currentMinutes() { return static_cast<u32>(osGetTime() / 60000 - minutesFrom1900To2000); }
+
+PlayHistory::PlayHistory(const PtmPlayEvent* events, size_t count, bool full)
+    : m_valid(true)
+    , m_full(full)
+    , m_oldestEvent(UINT32_MAX)
+    , m_lastTimeChange(0) {
+    addEvents(events, count);
+}
+
+PlayHistory::PlayHistory()
+    : m_valid(false)
+    , m_full(false)
+    , m_oldestEvent(UINT32_MAX)
+    , m_lastTimeChange(0) {
+    PROFILE_SCOPE("Load Play History");
+    auto lock = s_ptmMutex.lock();
+
+    Result res;
+    if(R_FAILED(res = ptmPlaysInit())) {
+        Logger::warn("Play History", "Failed to init ptm:plays");
+        Logger::warn("Play History", res);
+
+        return;
+    }
+
+    s32 start, size;
+    if(R_FAILED(res = PTMPLAYS_GetPlayHistoryStart(&start)) || R_FAILED(res = PTMPLAYS_GetPlayHistorySize(&size))) {
+        Logger::warn("Play History", "Failed to get play history range");
+        Logger::warn("Play History", res);
+
+        ptmPlaysExit();
+        return;
+    }
+
+    std::unique_ptr<PtmPlayEvent[]> events = std::make_unique<PtmPlayEvent[]>(READ_BATCH);
+    m_full                                 = static_cast<u32>(size) >= PTM_MAX_PLAY_EVENTS;
+
+    s32 index = start;
+    for(s32 remaining = size; remaining > 0;) {
+        s32 count = std::min(remaining, READ_BATCH);
+        s32 end;
+
+        if(R_FAILED(res = PTMPLAYS_GetPlayHistory(&end, events.get(), index, count)) || R_FAILED(res = PTMPLAYS_CalcPlayHistoryStart(&index, index, count))) {
+            Logger::warn("Play History", "Failed to read play history");
+            Logger::warn("Play History", res);
+
+            ptmPlaysExit();
+            return;
+        }
+
+        addEvents(events.get(), static_cast<size_t>(count));
+        remaining -= count;
+    }
+
+    ptmPlaysExit();
+
+    Logger::info("Play History", "Read {} events for {} titles", size, m_lastPlayed.size());
+    m_valid = true;
+}
+
+bool PlayHistory::valid() const { return m_valid; }
+
+void PlayHistory::addEvents(const PtmPlayEvent* events, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        const PtmPlayEvent& event = events[i];
+        const u32 minutes         = event.minutesSince2000;
+
+        m_oldestEvent = std::min(m_oldestEvent, minutes);
+
+        switch(event.type) {
+        case PTMPLAYEVENT_USER_TIME_CHANGE_OLD_TIME:
+        case PTMPLAYEVENT_USER_TIME_CHANGE_NEW_TIME:
+            m_lastTimeChange = std::max(m_lastTimeChange, minutes);
+            break;
+        case PTMPLAYEVENT_SHELL_CLOSE:
+        case PTMPLAYEVENT_SHELL_OPEN:
+        case PTMPLAYEVENT_SYSTEM_SHUTDOWN:
+            break;
+        default: {
+            const u64 id = ptmGetPlayEventTitleId(event);
+            if(id == PTM_INVALID_TITLE_ID) {
+                break;
+            }
+
+            u32& lastPlayed = m_lastPlayed[id];
+            lastPlayed      = std::max(lastPlayed, minutes);
+            break;
+        }
+        }
+    }
+}
+
+bool PlayHistory::playedSince(u64 id, u32 minutes) const {
+    if(!m_valid) {
+        return true;
+    }
+
+    // times after a clock change can't be compared, and a wrapped log may have lost the launch
+    if(m_lastTimeChange >= minutes || (m_full && m_oldestEvent >= minutes)) {
+        return true;
+    }
+
+    auto it = m_lastPlayed.find(id);
+    return it != m_lastPlayed.end() && it->second >= minutes;
+}
+
+u32 PlayHistory::lastPlayed(u64 id) const {
+    auto it = m_lastPlayed.find(id);
+    return it != m_lastPlayed.end() ? it->second : 0;
+}
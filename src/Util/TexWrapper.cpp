@@ -1,5 +1,9 @@
+#include <Util/Mutex.hpp>
 #include <Util/TexWrapper.hpp>
 
+// textures are created by the title loading threads, keep linear heap allocations off each other
+static Mutex s_texMutex;
+
 std::shared_ptr<TexWrapper> TexWrapper::create(u16 width, u16 height, GPU_TEXCOLOR format) {
     struct make_shared_enabler : public TexWrapper {
         make_shared_enabler(u16 width, u16 height, GPU_TEXCOLOR format)
@@ -10,10 +14,12 @@ std::shared_ptr<TexWrapper> TexWrapper::create(u16 width, u16 height, GPU_TEXCOL
 }
 
 TexWrapper::TexWrapper(u16 width, u16 height, GPU_TEXCOLOR format) {
+    auto lock = s_texMutex.lock();
     C3D_TexInit(&m_tex, width, height, format);
 }
 
 TexWrapper::~TexWrapper() {
+    auto lock = s_texMutex.lock();
     C3D_TexDelete(&m_tex);
 }
 
@@ -17,13 +17,31 @@ Worker::Worker(std::function<void(Worker*)> workerFunction, int priorityOffset,
     m_priority = std::clamp(priority - priorityOffset, 0x18L, 0x3FL);
 }
 
+std::vector<Worker::Processor> Worker::availableProcessors() {
+    std::vector<Processor> processors = { APPCORE, SYSCORE };
+
+    bool isNew3DS = false;
+    if(R_SUCCEEDED(APT_CheckNew3DS(&isNew3DS)) && isNew3DS) {
+        processors.push_back(THREE);
+        processors.push_back(FOUR);
+    }
+
+    return processors;
+}
+
+Worker::Processor Worker::currentProcessor() { return static_cast<Processor>(svcGetProcessorID()); }
+
 void Worker::setWorkerFunc(std::function<void(Worker*)> func) { m_workerFunction = func; }
 bool Worker::running() const { return m_thread != nullptr && m_threadStarted && threadGetExitCode(m_thread) != 1; }
 bool Worker::waitingForExit() const { return m_waitingForExit; }
 
-void Worker::start() {
-    if(m_workerFunction == nullptr || running()) {
-        return;
+bool Worker::start() {
+    if(m_workerFunction == nullptr) {
+        return false;
+    }
+
+    if(running()) {
+        return true;
     }
 
     waitForExit();
@@ -31,6 +49,8 @@ void Worker::start() {
 
     m_threadStarted = true;
     m_thread        = threadCreate(&Worker::onThreadStart, this, m_stackSize + 0x1000, m_priority, m_processor, false);
+
+    return m_thread != nullptr;
 }
 
 void Worker::signalShouldExit() {
@@ -0,0 +1,40 @@
+#include <Util/WorkerPool.hpp>
+#include <algorithm>
+
+WorkerPool::WorkerPool(std::function<void(Worker*)> workerFunction, int priorityOffset, size_t stackSize, std::vector<Worker::Processor> processors) {
+    m_workers.reserve(processors.size());
+
+    for(Worker::Processor processor : processors) {
+        m_workers.push_back(std::make_unique<Worker>(workerFunction, priorityOffset, stackSize, processor));
+    }
+}
+
+WorkerPool::~WorkerPool() { waitForExit(); }
+
+size_t WorkerPool::size() const { return m_workers.size(); }
+bool WorkerPool::running() const {
+    return std::any_of(m_workers.begin(), m_workers.end(), [](const std::unique_ptr<Worker>& worker) { return worker->running(); });
+}
+
+size_t WorkerPool::start() {
+    size_t started = 0;
+    for(auto& worker : m_workers) {
+        if(worker->start()) {
+            started++;
+        }
+    }
+
+    return started;
+}
+
+void WorkerPool::waitForExit() {
+    for(auto& worker : m_workers) {
+        worker->waitForExit();
+    }
+}
+
+void WorkerPool::signalShouldExit() {
+    for(auto& worker : m_workers) {
+        worker->signalShouldExit();
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef MD5_REFERENCE_H
+#define MD5_REFERENCE_H
+
+#include <md5.h>
+
+void referenceMd5Init(MD5Context* ctx);
+void referenceMd5Update(MD5Context* ctx, const uint8_t* input, size_t input_len);
+void referenceMd5Finalize(MD5Context* ctx);
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Compares ext/src/md5.c against the implementation it replaced, MB/s for each update size.
+ * Both have to produce the same digest, a mismatch fails the run.
+ */
+
+#include "md5Reference.h"
+
+#include <md5.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef void (*InitFunc)(MD5Context* ctx);
+typedef void (*UpdateFunc)(MD5Context* ctx, const uint8_t* input, size_t input_len);
+typedef void (*FinalizeFunc)(MD5Context* ctx);
+
+typedef struct {
+    const char* name;
+    InitFunc init;
+    UpdateFunc update;
+    FinalizeFunc finalize;
+} Implementation;
+
+// bytes hashed per measurement, in updates of each size
+#define TOTAL_SIZE (64u * 1024u * 1024u)
+
+static const size_t UPDATE_SIZES[] = { 64, 1024, 16 * 1024, 64 * 1024, 1024 * 1024 };
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// hashes TOTAL_SIZE bytes of data in updates of updateSize, returns MB/s
+static double measure(const Implementation* impl, const uint8_t* data, size_t updateSize, uint8_t* digest) {
+    MD5Context ctx;
+
+    const double start = now();
+    impl->init(&ctx);
+
+    for(size_t done = 0; done < TOTAL_SIZE; done += updateSize) {
+        impl->update(&ctx, data, updateSize);
+    }
+
+    impl->finalize(&ctx);
+    const double elapsed = now() - start;
+
+    memcpy(digest, ctx.digest, 16);
+    return (double)TOTAL_SIZE / (1024.0 * 1024.0) / elapsed;
+}
+
+int main(void) {
+    const Implementation reference = { "reference", referenceMd5Init, referenceMd5Update, referenceMd5Finalize };
+    const Implementation current   = { "md5.c", md5Init, md5Update, md5Finalize };
+
+    const size_t maxSize = UPDATE_SIZES[sizeof(UPDATE_SIZES) / sizeof(UPDATE_SIZES[0]) - 1];
+
+    // one extra byte so each size also runs from an unaligned start
+    uint8_t* buffer = malloc(maxSize + 1);
+    if(buffer == NULL) {
+        return 1;
+    }
+
+    // xorshift so the contents don't repeat
+    uint32_t state = 0x12345678;
+    for(size_t i = 0; i < maxSize + 1; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        buffer[i] = (uint8_t)state;
+    }
+
+    int failed = 0;
+    printf("%-10s %-9s %12s %12s %8s\n", "update", "alignment", "reference", "md5.c", "speedup");
+
+    for(size_t i = 0; i < sizeof(UPDATE_SIZES) / sizeof(UPDATE_SIZES[0]); i++) {
+        for(size_t offset = 0; offset < 2; offset++) {
+            uint8_t referenceDigest[16], currentDigest[16];
+
+            const double referenceRate = measure(&reference, buffer + offset, UPDATE_SIZES[i], referenceDigest);
+            const double currentRate   = measure(&current, buffer + offset, UPDATE_SIZES[i], currentDigest);
+
+            printf("%-10zu %-9s %9.1f MB/s %7.1f MB/s %7.2fx\n", UPDATE_SIZES[i], offset == 0 ? "aligned" : "unaligned", referenceRate, currentRate, currentRate / referenceRate);
+
+            if(memcmp(referenceDigest, currentDigest, 16) != 0) {
+                fprintf(stderr, "digest mismatch for %zu byte updates\n", UPDATE_SIZES[i]);
+                failed = 1;
+            }
+        }
+    }
+
+    free(buffer);
+    return failed;
+}